@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    AutoGain.cpp
+    Created: 21 Oct 2026 1:02:54am
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "AutoGain.h"
+#include "WaveShaperKernels.h"
+
+AutoGain::AutoGain(const juce::AudioProcessorValueTreeState& apvts) : apvts(apvts) {}
+
+AutoGain::~AutoGain() {
+    worker->remove(*this);
+}
+
+void AutoGain::prepare() {
+    worker->remove(*this);
+    update(getChainSettings(apvts));
+    hasChanged = false;     // the settings being prepared start out with it
+    worker->add(*this);
+}
+
+void AutoGain::runTask() {
+    const ChainSettings chainSettings = getChainSettings(apvts);
+    if (chainSettings.AutoGain && getCurveState(chainSettings) != estimatedState) update(chainSettings);
+}
+
+bool AutoGain::dependsOn(int parameterIndex) {
+    switch (parameterIndex) {
+        case PosPreGain: case PosBias: case PosWaveShapeAmount: case PosWaveShapeFunction: case PosBands:
+        case PosBand1Gain: case PosBand2WaveShapeAmount: case PosBand2WaveShapeFunction: case PosBand2Gain:
+        case PosBand3WaveShapeAmount: case PosBand3WaveShapeFunction: case PosBand3Gain:
+        case PosBand4WaveShapeAmount: case PosBand4WaveShapeFunction: case PosBand4Gain: case PosAutoGain:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void AutoGain::update(const ChainSettings& chainSettings) {
+    auto state = getCurveState(chainSettings);
+    auto cached = cache.find(state);
+    if (cached == cache.end()) {
+        if (cache.size() >= MaxCacheSize) cache.clear();
+        cached = cache.emplace(state, estimate(chainSettings)).first;
+    }
+    estimatedState = std::move(state);
+    if (cached->second != compensation.load()) {
+        compensation = cached->second;
+        hasChanged = true;
+    }
+}
+
+std::vector<float> AutoGain::getCurveState(const ChainSettings& chainSettings) {
+    std::vector<float> state{ (float)chainSettings.NumBands, chainSettings.PreGain, chainSettings.Bias };
+    for (int band = 0; band < chainSettings.NumBands; band++) {
+        state.push_back((float)chainSettings.WaveShapeFunction[band]);
+        state.push_back(chainSettings.WaveShapeAmount[band]);
+        state.push_back(chainSettings.BandGain[band]);
+    }
+    return state;
+}
+
+float AutoGain::estimate(const ChainSettings& chainSettings) {
+    // the bands are assumed to share the signal's power equally; DC (from Bias or the curve) doesn't count as loudness
+    const float preGain = juce::Decibels::decibelsToGain(chainSettings.PreGain);
+    const float bandLevel = ReferenceLevel / std::sqrt((float)chainSettings.NumBands);
+    double inputPower = 0.0, outputPower = 0.0;
+    for (int band = 0; band < chainSettings.NumBands; band++) {
+        const float bandGain = juce::Decibels::decibelsToGain(chainSettings.BandGain[band]);
+        double sum = 0.0, sumOfSquares = 0.0;
+        for (int i = 0; i < NumPoints; i++) {
+            const float x = bandLevel * (float)std::sin(juce::MathConstants<double>::twoPi * i / NumPoints);
+            const float y = bandGain * Kernels::shapeSample(chainSettings.WaveShapeFunction[band], (x * preGain) + chainSettings.Bias,
+                                                            chainSettings.WaveShapeAmount[band]);
+            sum += y;
+            sumOfSquares += (double)y * y;
+        }
+        const double mean = sum / NumPoints;
+        outputPower += (sumOfSquares / NumPoints) - (mean * mean);
+        inputPower += 0.5 * bandLevel * bandLevel;
+    }
+    if (outputPower <= MinOutputPower) return 0.f;
+    return juce::jlimit(-MaxCompensation, MaxCompensation, (float)(10.0 * std::log10(inputPower / outputPower)));
+}
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    AutoGain.h
+    Created: 21 Oct 2026 1:02:37am
+    Author:  traxx
+
+    Loudness compensation for the waveshaper: the RMS gain of the current curves (with PreGain and Bias) for a
+    reference sine is estimated in the background and its inverse is added to PostGain
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Chain.h"
+#include "../Helpers/BackgroundWorker.h"
+
+class AutoGain : private BackgroundWorker::Task {
+public:
+    AutoGain(const juce::AudioProcessorValueTreeState& apvts);
+    ~AutoGain() override;
+
+    // estimates the current settings synchronously, afterwards they are re-estimated in the background on requestUpdate
+    void prepare();
+    void requestUpdate() { worker->request(*this); }     // any thread; for changes of the parameters in dependsOn
+    static bool dependsOn(int parameterIndex);
+    float getCompensation() const { return compensation.load(); }     // dB to add to PostGain
+    bool pullChange() { return hasChanged.exchange(false); }          // true once after every new estimate
+
+    static float estimate(const ChainSettings& chainSettings);         // dB, within +-MaxCompensation
+
+private:
+    static constexpr int NumPoints = 1024;          // of one period of the reference sine
+    static constexpr float ReferenceLevel = 0.5f;   // -6 dBFS peak
+    static constexpr float MaxCompensation = 24.f;
+    static constexpr double MinOutputPower = 1e-12; // -120 dB; below it the curves mute the band and nothing is compensated
+    static constexpr size_t MaxCacheSize = 256;
+
+    void runTask() override;
+    void update(const ChainSettings& chainSettings);
+    static std::vector<float> getCurveState(const ChainSettings& chainSettings);     // everything the estimate depends on
+
+    const juce::AudioProcessorValueTreeState& apvts;
+    juce::SharedResourcePointer<BackgroundWorker> worker;
+    std::map<std::vector<float>, float> cache;      // only used by the worker and prepare, never at the same time
+    std::vector<float> estimatedState;
+    std::atomic<float> compensation{ 0.f };
+    std::atomic<bool> hasChanged{ false };
+};
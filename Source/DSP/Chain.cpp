@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    Chain.cpp
+    Created: 19 Oct 2026 11:02:31am
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "Chain.h"
+
+void updatePeakFilter(Filter& peak, const ChainSettings& chainSettings, double sampleRate) {
+    *peak.coefficients = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(
+        sampleRate, chainSettings.PeakFreq, chainSettings.PeakQ,
+        juce::Decibels::decibelsToGain(chainSettings.PeakGain)); // convert decibels to gain value
+}
+
+// one second order section of a Butterworth cascade, from the tables if given
+template<int Index> static void updateCutFilterStage(CutFilter& filter, float frequency, int numStages, double sampleRate, bool isHighpass,
+                                                     const CutCoefficientTables* tables) {
+    using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+    const bool isActive = Index < numStages;
+    if (isActive) {
+        if (tables != nullptr) *filter.get<Index>().coefficients = tables->lookup(isHighpass, numStages, Index, frequency);
+        else {
+            const float Q = getButterworthSectionQ(numStages, Index);
+            *filter.get<Index>().coefficients = isHighpass ? ArrayCoefficients::makeHighPass(sampleRate, frequency, Q)
+                                                           : ArrayCoefficients::makeLowPass(sampleRate, frequency, Q);
+        }
+        if (filter.isBypassed<Index>()) filter.get<Index>().reset();  // don't resume from stale state when slope gets steeper
+    }
+    filter.setBypassed<Index>(!isActive);
+}
+void updateCutFilter(CutFilter& filter, float frequency, FilterSlope slope, double sampleRate, bool isHighpass, const CutCoefficientTables* tables) {
+    jassert(tables == nullptr || tables->getSampleRate() == sampleRate);
+    const int numStages = slope + 1;    // 12 dB per stage
+    updateCutFilterStage<0>(filter, frequency, numStages, sampleRate, isHighpass, tables);
+    updateCutFilterStage<1>(filter, frequency, numStages, sampleRate, isHighpass, tables);
+    updateCutFilterStage<2>(filter, frequency, numStages, sampleRate, isHighpass, tables);
+    updateCutFilterStage<3>(filter, frequency, numStages, sampleRate, isHighpass, tables);
+}
+
+double getFilterMagnitudeForFrequency(const MonoChain& chain, double frequency, double sampleRate) {
+    auto& loCut = chain.get<ChainPositions::LoCut>();
+    auto& peak = chain.get<ChainPositions::Peak>();
+    auto& hiCut = chain.get<ChainPositions::HiCut>();
+
+    double mag = 1.f;   // init gain magnitude
+    if (!loCut.isBypassed<0>()) mag *= loCut.get<0>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    if (!loCut.isBypassed<1>()) mag *= loCut.get<1>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    if (!loCut.isBypassed<2>()) mag *= loCut.get<2>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    if (!loCut.isBypassed<3>()) mag *= loCut.get<3>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    mag *= peak.coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    if (!hiCut.isBypassed<0>()) mag *= hiCut.get<0>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    if (!hiCut.isBypassed<1>()) mag *= hiCut.get<1>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    if (!hiCut.isBypassed<2>()) mag *= hiCut.get<2>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    if (!hiCut.isBypassed<3>()) mag *= hiCut.get<3>().coefficients->getMagnitudeForFrequency(frequency, sampleRate);
+    return mag;
+}
+
+
+
+ChainSettings getChainSettings(const juce::AudioProcessorValueTreeState& apvts) {
+    ChainSettings settings;
+
+    settings.LoCutFreq = apvts.getRawParameterValue("LoCutFreq")->load();
+    settings.LoCutSlope = static_cast<FilterSlope>(apvts.getRawParameterValue("LoCutSlope")->load());
+    settings.PeakFreq = apvts.getRawParameterValue("PeakFreq")->load();
+    settings.PeakGain = apvts.getRawParameterValue("PeakGain")->load();
+    settings.PeakQ = apvts.getRawParameterValue("PeakQ")->load();
+    settings.HiCutFreq = apvts.getRawParameterValue("HiCutFreq")->load();
+    settings.HiCutSlope = static_cast<FilterSlope>(apvts.getRawParameterValue("HiCutSlope")->load());
+
+    settings.PreGain = apvts.getRawParameterValue("PreGain")->load();
+    settings.Bias = apvts.getRawParameterValue("Bias")->load();
+    settings.PostGain = apvts.getRawParameterValue("PostGain")->load();
+    settings.Mix = apvts.getRawParameterValue("DryWet")->load();
+    settings.LinearPhase = apvts.getRawParameterValue("LinearPhase")->load() > 0.5f;
+    settings.Precision = static_cast<MathPrecision>(apvts.getRawParameterValue("Precision")->load());
+    settings.Economy = apvts.getRawParameterValue("Economy")->load() > 0.5f;
+    settings.DCBlock = apvts.getRawParameterValue("DCBlock")->load() > 0.5f;
+    settings.AutoGain = apvts.getRawParameterValue("AutoGain")->load() > 0.5f;
+
+    // IDs spelled out, so reading them on the audio thread doesn't build strings
+    static const char* const crossoverIDs[MaxBands - 1] = { "CrossoverFreq1", "CrossoverFreq2", "CrossoverFreq3" };
+    static const char* const bandGainIDs[MaxBands] = { "Band1Gain", "Band2Gain", "Band3Gain", "Band4Gain" };
+    static const char* const bandAmountIDs[MaxBands] = { "WaveShapeAmount", "Band2WaveShapeAmount", "Band3WaveShapeAmount", "Band4WaveShapeAmount" };
+    static const char* const bandFunctionIDs[MaxBands] = { "WaveShapeFunction", "Band2WaveShapeFunction", "Band3WaveShapeFunction", "Band4WaveShapeFunction" };
+    settings.NumBands = static_cast<int>(apvts.getRawParameterValue("Bands")->load()) + 1;
+    for (int i = 0; i < MaxBands - 1; i++) {
+        settings.CrossoverFreq[i] = apvts.getRawParameterValue(crossoverIDs[i])->load();
+    }
+    for (int band = 0; band < MaxBands; band++) {
+        settings.BandGain[band] = apvts.getRawParameterValue(bandGainIDs[band])->load();
+        settings.WaveShapeAmount[band] = apvts.getRawParameterValue(bandAmountIDs[band])->load();
+        settings.WaveShapeFunction[band] = static_cast<WaveShaperFunction>(apvts.getRawParameterValue(bandFunctionIDs[band])->load());
+    }
+
+    settings.MidSide = apvts.getRawParameterValue("MidSide")->load() > 0.5f;
+    settings.SideWaveShapeAmount = apvts.getRawParameterValue("SideWaveShapeAmount")->load();
+    settings.SideWaveShapeFunction = static_cast<WaveShaperFunction>(apvts.getRawParameterValue("SideWaveShapeFunction")->load());
+    settings.SideGain = apvts.getRawParameterValue("SideGain")->load();
+
+    settings.EnvAmount = apvts.getRawParameterValue("EnvAmount")->load();
+    settings.EnvDrive = apvts.getRawParameterValue("EnvDrive")->load();
+    settings.EnvAttack = apvts.getRawParameterValue("EnvAttack")->load();
+    settings.EnvRelease = apvts.getRawParameterValue("EnvRelease")->load();
+    settings.EnvDetector = static_cast<int>(apvts.getRawParameterValue("EnvDetector")->load());
+    settings.EnvSidechain = apvts.getRawParameterValue("EnvSidechain")->load() > 0.5f;
+
+    static const char* const lfoRateIDs[NumLFOs] = { "LFO1Rate", "LFO2Rate" };
+    static const char* const lfoShapeIDs[NumLFOs] = { "LFO1Shape", "LFO2Shape" };
+    static const char* const modSourceIDs[NumModulationSlots] = { "Mod1Source", "Mod2Source", "Mod3Source", "Mod4Source" };
+    static const char* const modTargetIDs[NumModulationSlots] = { "Mod1Target", "Mod2Target", "Mod3Target", "Mod4Target" };
+    static const char* const modDepthIDs[NumModulationSlots] = { "Mod1Depth", "Mod2Depth", "Mod3Depth", "Mod4Depth" };
+    for (int lfo = 0; lfo < NumLFOs; lfo++) {
+        settings.LFORate[lfo] = static_cast<int>(apvts.getRawParameterValue(lfoRateIDs[lfo])->load());
+        settings.LFOShape[lfo] = static_cast<int>(apvts.getRawParameterValue(lfoShapeIDs[lfo])->load());
+    }
+    for (int slot = 0; slot < NumModulationSlots; slot++) {
+        settings.ModSource[slot] = static_cast<int>(apvts.getRawParameterValue(modSourceIDs[slot])->load());
+        settings.ModTarget[slot] = static_cast<int>(apvts.getRawParameterValue(modTargetIDs[slot])->load());
+        settings.ModDepth[slot] = apvts.getRawParameterValue(modDepthIDs[slot])->load();
+    }
+
+    return settings;
+}
+
+bool isChainSettingsParameter(int parameterIndex) {
+    switch (parameterIndex) {
+        case PosDisplayON: case PosDisplayHQ: case PosBypass:
+        case PosAnalyzerPreTap: case PosAnalyzerPostTap: case PosDisplayMode:
+            return false;
+        default:
+            return true;
+    }
+}
+
+double getFilterRingOutSeconds(const ChainSettings& chainSettings) {
+    using namespace juce;
+    // a resonant section decays with a time constant of Q / (pi * f); 120 dB take about 13.8 of those
+    auto decaySeconds = [](double frequency, double Q) { return 13.8 * Q / (MathConstants<double>::pi * frequency); };
+    auto highestButterworthQ = [](int slope) {  // Q of the last section of the cascade
+        const double order = (slope + 1) * 2;
+        return 1.0 / (2.0 * std::cos((order - 1.0) * MathConstants<double>::pi / (order * 2.0)));
+    };
+
+    double seconds = decaySeconds(chainSettings.LoCutFreq, highestButterworthQ(chainSettings.LoCutSlope));
+    seconds = jmax(seconds, decaySeconds(chainSettings.HiCutFreq, highestButterworthQ(chainSettings.HiCutSlope)));
+    if (chainSettings.PeakGain != 0.f) seconds = jmax(seconds, decaySeconds(chainSettings.PeakFreq, chainSettings.PeakQ));
+    if (chainSettings.NumBands > 1) seconds = jmax(seconds, decaySeconds(chainSettings.CrossoverFreq[0], MathConstants<double>::sqrt2 / 2.0));
+    if (chainSettings.DCBlock) seconds = jmax(seconds, decaySeconds(DCBlockerFrequency, 0.5));     // one pole, time constant 1 / (2 pi f)
+    return seconds;
+}
+
+ChainSettings interpolateChainSettings(const ChainSettings& from, const ChainSettings& to, float alpha) {
+    auto lin = [alpha](float a, float b) { return a + ((b - a) * alpha); };
+    auto geo = [alpha](float a, float b) { return a * std::pow(b / a, alpha); };    // equal steps per octave
+    ChainSettings settings = to;
+
+    settings.LoCutFreq = geo(from.LoCutFreq, to.LoCutFreq);
+    settings.PeakFreq = geo(from.PeakFreq, to.PeakFreq);
+    settings.PeakGain = lin(from.PeakGain, to.PeakGain);
+    settings.PeakQ = lin(from.PeakQ, to.PeakQ);
+    settings.HiCutFreq = geo(from.HiCutFreq, to.HiCutFreq);
+
+    settings.PreGain = lin(from.PreGain, to.PreGain);
+    settings.Bias = lin(from.Bias, to.Bias);
+    settings.PostGain = lin(from.PostGain, to.PostGain);
+    settings.Mix = lin(from.Mix, to.Mix);
+
+    for (int i = 0; i < MaxBands - 1; i++) settings.CrossoverFreq[i] = geo(from.CrossoverFreq[i], to.CrossoverFreq[i]);
+    for (int band = 0; band < MaxBands; band++) {
+        settings.WaveShapeAmount[band] = lin(from.WaveShapeAmount[band], to.WaveShapeAmount[band]);
+        settings.BandGain[band] = lin(from.BandGain[band], to.BandGain[band]);
+    }
+    settings.SideWaveShapeAmount = lin(from.SideWaveShapeAmount, to.SideWaveShapeAmount);
+    settings.SideGain = lin(from.SideGain, to.SideGain);
+    settings.EnvAmount = lin(from.EnvAmount, to.EnvAmount);
+    settings.EnvDrive = lin(from.EnvDrive, to.EnvDrive);
+    for (int slot = 0; slot < NumModulationSlots; slot++) settings.ModDepth[slot] = lin(from.ModDepth[slot], to.ModDepth[slot]);
+
+    return settings;
+}
@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    Chain.h
+    Created: 19 Oct 2026 11:02:14am
+    Author:  traxx
+
+    Parameter and processing chain definitions shared by the processor, its DSP stages and the UI
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CoefficientTables.h"
+
+enum FilterSlope {
+    Slope12,
+    Slope24,
+    Slope36,
+    Slope48
+};
+
+enum WaveShaperFunction {
+    HardClip,
+    SoftClip,
+    Cracked,
+    GNOME,
+    Warm,
+    Quantize,
+    Fuzz,
+    Hollowing,
+    Sin,
+    Rash,
+    Spiked,
+    Titruff
+};
+
+const juce::StringArray WaveShaperOptions = {
+    "Hard Clip",
+    "Soft Clip",
+    "Cracked",
+    "GNOME",
+    "Warm",
+    "Quantize",
+    "Fuzz",
+    "Hollowing",
+    "Sin",
+    "Rash",
+    "Spiked",
+    "Titruff"
+};
+
+enum TreeParameter {
+    PosLoCutFreq,
+    PosLoCutSlope,
+    PosPeakFreq,
+    PosPeakGain,
+    PosPeakQ,
+    PosHiCutFreq,
+    PosHiCutSlope,
+    PosPreGain,
+    PosBias,
+    PosWaveShapeAmount,
+    PosWaveShapeFunction,
+    PosPostGain,
+    PosDryWet,
+    PosDisplayON,
+    PosDisplayHQ,
+    PosBypass,
+    PosLinearPhase,
+    PosBands,
+    PosCrossoverFreq1,
+    PosCrossoverFreq2,
+    PosCrossoverFreq3,
+    PosBand1Gain,
+    PosBand2WaveShapeAmount,
+    PosBand2WaveShapeFunction,
+    PosBand2Gain,
+    PosBand3WaveShapeAmount,
+    PosBand3WaveShapeFunction,
+    PosBand3Gain,
+    PosBand4WaveShapeAmount,
+    PosBand4WaveShapeFunction,
+    PosBand4Gain,
+    PosPrecision,
+    PosEconomy,
+    PosMidSide,
+    PosSideWaveShapeAmount,
+    PosSideWaveShapeFunction,
+    PosSideGain,
+    PosEnvAmount,
+    PosEnvDrive,
+    PosEnvAttack,
+    PosEnvRelease,
+    PosEnvDetector,
+    PosEnvSidechain,
+    PosLFO1Rate,
+    PosLFO1Shape,
+    PosLFO2Rate,
+    PosLFO2Shape,
+    PosMod1Source,
+    PosMod1Target,
+    PosMod1Depth,
+    PosMod2Source,
+    PosMod2Target,
+    PosMod2Depth,
+    PosMod3Source,
+    PosMod3Target,
+    PosMod3Depth,
+    PosMod4Source,
+    PosMod4Target,
+    PosMod4Depth,
+    PosDCBlock,
+    PosAutoGain,
+    PosAnalyzerPreTap,
+    PosAnalyzerPostTap,
+    PosDisplayMode
+};
+
+enum MathPrecision {
+    PrecisionAuto,      // fast while playing in realtime, exact for offline renders
+    PrecisionExact,
+    PrecisionFast
+};
+
+constexpr int MaxBands = 4;     // multiband distortion; band 1 uses the main WaveShapeAmount/WaveShapeFunction parameters
+constexpr float DCBlockerFrequency = 10.f;   // cutoff of the optional DC blocker after the waveshaper
+
+// analyzer tap points; the pre and post analyzer curves can each show any of them
+enum AnalyzerTap {
+    TapInput,
+    TapFiltered,    // after the filters, before the waveshaper
+    TapDistorted,   // after the DistortionEngine (band and side gains applied, mid/side decoded), without PostGain
+    TapOutput       // after PostGain, before the dry/wet mix
+};
+
+const juce::StringArray AnalyzerTapOptions = {
+    "Input",
+    "Filtered",
+    "Distorted",
+    "Output"
+};
+
+enum AnalyzerMode {
+    ModeInstant,
+    ModeAverage,    // exponential average per bin
+    ModePeakHold,   // highest level per bin, slowly falling back
+    ModeSpectrogram // scrolling, of the post curve
+};
+
+const juce::StringArray AnalyzerModeOptions = {
+    "Instant",
+    "Average",
+    "Peak Hold",
+    "Spectrogram"
+};
+
+// modulation matrix, see ModulationMatrix
+constexpr int NumLFOs = 2;
+constexpr int NumModulationSlots = 4;
+
+enum ModulationSource {
+    SourceNone,
+    SourceLFO1,
+    SourceLFO2,
+    SourceEnvelope
+};
+
+const juce::StringArray ModulationSourceOptions = {
+    "None",
+    "LFO 1",
+    "LFO 2",
+    "Envelope"
+};
+
+enum LFOShape {
+    ShapeSine,
+    ShapeTriangle,
+    ShapeSaw,
+    ShapeSquare
+};
+
+const juce::StringArray LFOShapeOptions = {
+    "Sine",
+    "Triangle",
+    "Saw",
+    "Square"
+};
+
+const juce::StringArray LFORateOptions = {     // tempo synced, length of one cycle
+    "1/16",
+    "1/8",
+    "1/4",
+    "1/2",
+    "1 Bar",
+    "2 Bars",
+    "4 Bars"
+};
+
+struct ChainSettings {
+    float LoCutFreq{ 0 }, PeakFreq{ 0 }, PeakGain{ 0 }, PeakQ{ 0 }, HiCutFreq{ 0 }, PreGain{ 0 }, Bias{ 0 }, PostGain{ 0 }, Mix{ 0 };
+    int LoCutSlope{ FilterSlope::Slope12 }, HiCutSlope{ FilterSlope::Slope12 };
+    bool LinearPhase{ false };
+    int Precision{ MathPrecision::PrecisionAuto };
+    bool Economy{ false };      // CPU budget profile for large sessions, see LoadScheduler
+    bool DCBlock{ false };      // removes the DC that Bias and asymmetric curves add
+    bool AutoGain{ false };     // PostGain compensates the waveshaper's loudness change, see AutoGain
+
+    // per band, lowest band first
+    int NumBands{ 1 };
+    std::array<float, MaxBands - 1> CrossoverFreq{};
+    std::array<float, MaxBands> WaveShapeAmount{}, BandGain{};
+    std::array<int, MaxBands> WaveShapeFunction{};
+
+    // mid/side mode; the main waveshaper settings then apply to the mid signal
+    bool MidSide{ false };
+    float SideWaveShapeAmount{ 0 }, SideGain{ 0 };
+    int SideWaveShapeFunction{ WaveShaperFunction::HardClip };
+
+    // dynamic drive: an envelope of the distortion input (or the sidechain) modulates amount and pre-gain
+    float EnvAmount{ 0 }, EnvDrive{ 0 }, EnvAttack{ 0 }, EnvRelease{ 0 };
+    int EnvDetector{ 0 };
+    bool EnvSidechain{ false };
+
+    // modulation matrix; targets index ModulationTargets (0 = none), depth is a fraction of the target's range
+    std::array<int, NumLFOs> LFORate{}, LFOShape{};
+    std::array<int, NumModulationSlots> ModSource{}, ModTarget{};
+    std::array<float, NumModulationSlots> ModDepth{};
+};
+
+using Filter = juce::dsp::IIR::Filter<float>;   // alias for Filters
+using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;     // ProcessorChain which allows to automatically run signal through all specified DSP instances (4 filter slope types)
+
+using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>; // filter chain for one channel, followed by the (stereo) DistortionEngine
+enum ChainPositions {
+    LoCut,
+    Peak,
+    HiCut
+};
+
+// filter design writes coefficients into the existing filters, so it never allocates once the chains are prepared;
+// cut filters are looked up in the tables when given (matching sample rate), designed directly otherwise
+void updatePeakFilter(Filter& peak, const ChainSettings& chainSettings, double sampleRate);
+void updateCutFilter(CutFilter& filter, float frequency, FilterSlope slope, double sampleRate, bool isHighpass, const CutCoefficientTables* tables = nullptr);
+inline void updateLoCutFilter(CutFilter& filter, const ChainSettings& chainSettings, double sampleRate, const CutCoefficientTables* tables = nullptr) {
+    updateCutFilter(filter, chainSettings.LoCutFreq, static_cast<FilterSlope>(chainSettings.LoCutSlope), sampleRate, true, tables);
+}
+inline void updateHiCutFilter(CutFilter& filter, const ChainSettings& chainSettings, double sampleRate, const CutCoefficientTables* tables = nullptr) {
+    updateCutFilter(filter, chainSettings.HiCutFreq, static_cast<FilterSlope>(chainSettings.HiCutSlope), sampleRate, false, tables);
+}
+// combined response of all active filters of the chain
+double getFilterMagnitudeForFrequency(const MonoChain& chain, double frequency, double sampleRate);
+
+ChainSettings getChainSettings(const juce::AudioProcessorValueTreeState& apvts);
+// whether the parameter (TreeParameter index) is read into ChainSettings; display and bypass ones aren't
+bool isChainSettingsParameter(int parameterIndex);
+double getFilterRingOutSeconds(const ChainSettings& chainSettings);
+// blends continuous parameters (frequencies logarithmically), choices are taken from "to"
+ChainSettings interpolateChainSettings(const ChainSettings& from, const ChainSettings& to, float alpha);
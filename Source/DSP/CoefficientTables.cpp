@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    CoefficientTables.cpp
+    Created: 20 Oct 2026 8:11:09pm
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "CoefficientTables.h"
+
+void PeakCoefficientTable::Table::build(double sampleRate, float gainDecibels, float q) {
+    const float gainFactor = juce::Decibels::decibelsToGain(gainDecibels);
+    const float maxFrequency = (float)(sampleRate * 0.49);     // grid points above Nyquist hold the last valid design
+    for (int i = 0; i < LogFrequencyGrid::Size; i++) {
+        designs[i] = juce::dsp::IIR::ArrayCoefficients<float>::makePeakFilter(sampleRate, std::min(LogFrequencyGrid::getFrequency(i), maxFrequency), q, gainFactor);
+    }
+    gain = gainDecibels;
+    quality = q;
+    isValid = true;
+}
+
+void PeakCoefficientTable::prepare(double newSampleRate, float gainDecibels, float q) {
+    worker->remove(*this);      // waits for a build in progress
+    sampleRate = newSampleRate;
+    front->build(sampleRate, gainDecibels, q);
+    back->isValid = false;
+    state = Idle;
+    worker->add(*this);
+}
+
+bool PeakCoefficientTable::lookup(float gainDecibels, float q, float frequency, BiquadCoefficients& coefficients) {
+    auto isFor = [gainDecibels, q](const Table& table) { return table.isValid && table.gain == gainDecibels && table.quality == q; };
+    if (!isFor(*front) && state.load(std::memory_order_acquire) == Ready) {
+        std::swap(front, back);
+        state.store(Idle, std::memory_order_release);
+    }
+    if (isFor(*front)) {
+        coefficients = LogFrequencyGrid::lookup(front->designs, frequency);
+        return true;
+    }
+    const bool isSettled = gainDecibels == missedGain && q == missedQuality;
+    missedGain = gainDecibels;
+    missedQuality = q;
+    if (isSettled && state.load(std::memory_order_acquire) == Idle) {   // otherwise a later miss asks again
+        requestedGain = gainDecibels;
+        requestedQuality = q;
+        state.store(Requested, std::memory_order_release);
+        worker->request(*this);
+    }
+    return false;
+}
+
+void PeakCoefficientTable::runTask() {
+    int expected = Requested;
+    if (!state.compare_exchange_strong(expected, Building, std::memory_order_acquire)) return;
+    back->build(sampleRate, requestedGain, requestedQuality);
+    state.store(Ready, std::memory_order_release);
+}
+
+CutCoefficientTables::CutCoefficientTables(double sampleRate) : sampleRate(sampleRate) {
+    using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+    const float maxFrequency = (float)(sampleRate * 0.49);
+    for (int numStages = 1; numStages <= MaxStages; numStages++) {
+        for (int stage = 0; stage < numStages; stage++) {
+            const float q = getButterworthSectionQ(numStages, stage);
+            auto& lowpass = table[0][getSection(numStages, stage)];
+            auto& highpass = table[1][getSection(numStages, stage)];
+            for (int i = 0; i < LogFrequencyGrid::Size; i++) {
+                const float frequency = std::min(LogFrequencyGrid::getFrequency(i), maxFrequency);
+                lowpass[i] = ArrayCoefficients::makeLowPass(sampleRate, frequency, q);
+                highpass[i] = ArrayCoefficients::makeHighPass(sampleRate, frequency, q);
+            }
+        }
+    }
+}
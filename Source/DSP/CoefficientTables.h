@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    CoefficientTables.h
+    Created: 20 Oct 2026 8:10:52pm
+    Author:  traxx
+
+    Filter coefficients precomputed over a logarithmic frequency grid: a frequency change interpolates between the
+    two neighbouring designs instead of designing anew
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Helpers/BackgroundWorker.h"
+
+using BiquadCoefficients = std::array<float, 6>;    // as returned by IIR::ArrayCoefficients
+
+struct LogFrequencyGrid {
+    // ~51 points per octave; interpolation error against a direct design: cut < 0.04 dB, peak < 0.3 dB at Q 10 / 36 dB, < 0.05 dB at Q 1
+    static constexpr int Size = 512;
+    static constexpr float MinFreq = 20.f, MaxFreq = 20000.f;
+
+    static float getFrequency(int index) { return MinFreq * std::pow(MaxFreq / MinFreq, (float)index / (Size - 1)); }
+    // fractional grid position of a frequency
+    static float getPosition(float frequency) {
+        const float position = std::log(juce::jlimit(MinFreq, MaxFreq, frequency) / MinFreq) * ((Size - 1) / std::log(MaxFreq / MinFreq));
+        return juce::jlimit(0.f, (float)(Size - 1), position);
+    }
+    template<typename Table>
+    static BiquadCoefficients lookup(const Table& table, float frequency) {
+        const float position = getPosition(frequency);
+        const int index = std::min((int)position, Size - 2);
+        const float alpha = position - index;
+        BiquadCoefficients result;
+        for (int i = 0; i < 6; i++) result[i] = table[index][i] + ((table[index + 1][i] - table[index][i]) * alpha);
+        return result;
+    }
+};
+
+// Peak filter for one gain and Q. A new gain or Q is built on the BackgroundWorker into a second table, which the audio
+// thread swaps in once it is ready; until then callers design directly. Only the audio thread calls lookup.
+class PeakCoefficientTable : private BackgroundWorker::Task {
+public:
+    ~PeakCoefficientTable() override { worker->remove(*this); }
+
+    // builds the table for gainDecibels and q synchronously; not concurrently with lookup
+    void prepare(double newSampleRate, float gainDecibels, float q);
+    // false if there is no table for gainDecibels and q yet, the caller designs directly then. A build is only requested
+    // once two lookups in a row missed with the same gain and Q, so ramps and modulation of them don't queue stale builds
+    bool lookup(float gainDecibels, float q, float frequency, BiquadCoefficients& coefficients);
+
+private:
+    struct Table {
+        std::array<BiquadCoefficients, LogFrequencyGrid::Size> designs;
+        float gain = 0.f, quality = 0.f;
+        bool isValid = false;
+        void build(double sampleRate, float gainDecibels, float q);
+    };
+    enum BuildState { Idle, Requested, Building, Ready };
+
+    void runTask() override;
+
+    juce::SharedResourcePointer<BackgroundWorker> worker;
+    Table tables[2];
+    Table* front = &tables[0];      // the audio thread's
+    Table* back = &tables[1];       // the worker's while Requested/Building, swapped by the audio thread when Ready
+    std::atomic<int> state{ Idle };
+    float requestedGain = 0.f, requestedQuality = 0.f;  // written by the audio thread while Idle
+    float missedGain = 0.f, missedQuality = 0.f;        // of the last lookup without table
+    double sampleRate = 44100.0;
+};
+
+// Q of section stage of a Butterworth cascade of numStages second order sections, as in FilterDesign::designIIR...HighOrderButterworthMethod
+inline float getButterworthSectionQ(int numStages, int stage) {
+    const double order = numStages * 2;
+    return (float)(1.0 / (2.0 * std::cos((2.0 * stage + 1.0) * juce::MathConstants<double>::pi / (order * 2.0))));
+}
+
+// every section of every cut slope (1 to MaxStages sections), high- and lowpass, for one sample rate
+class CutCoefficientTables {
+public:
+    static constexpr int MaxStages = 4;
+
+    explicit CutCoefficientTables(double sampleRate);
+    double getSampleRate() const { return sampleRate; }
+    BiquadCoefficients lookup(bool isHighpass, int numStages, int stage, float frequency) const {
+        return LogFrequencyGrid::lookup(table[isHighpass ? 1 : 0][getSection(numStages, stage)], frequency);
+    }
+
+private:
+    static constexpr int NumSections = (MaxStages * (MaxStages + 1)) / 2;
+    static int getSection(int numStages, int stage) { return ((numStages * (numStages - 1)) / 2) + stage; }
+
+    const double sampleRate;
+    std::array<std::array<std::array<BiquadCoefficients, LogFrequencyGrid::Size>, NumSections>, 2> table;   // [lowpass/highpass][section]
+};
+
+// cut tables for the whole process (shared via juce::SharedResourcePointer), one per sample rate in use
+struct CutCoefficientRegistry {
+    std::shared_ptr<const CutCoefficientTables> acquire(double sampleRate) {
+        const juce::ScopedLock lock(registryLock);
+        auto& entry = entries[sampleRate];
+        auto tables = entry.lock();
+        if (tables == nullptr) {
+            tables = std::make_shared<const CutCoefficientTables>(sampleRate);
+            entry = tables;
+        }
+        return tables;
+    }
+
+private:
+    juce::CriticalSection registryLock;
+    std::map<double, std::weak_ptr<const CutCoefficientTables>> entries;
+};
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    DistortionEngine.cpp
+    Created: 19 Oct 2026 3:12:58pm
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "DistortionEngine.h"
+
+DistortionEngine::DistortionEngine() {
+    for (auto& filter : compensation) {
+        for (auto& allpass : filter) allpass.setType(Crossover::Type::allpass);
+    }
+    updateCrossovers();
+}
+
+void DistortionEngine::prepare(const juce::dsp::ProcessSpec& spec) {
+    for (auto& filter : splitter) filter.prepare(spec);
+    for (auto& filter : compensation) {
+        for (auto& allpass : filter) allpass.prepare(spec);
+    }
+    dcBlocker.resize(spec.numChannels);
+    for (auto& blocker : dcBlocker) blocker.prepare(spec.sampleRate, DCBlockerFrequency);
+    reset();
+}
+
+void DistortionEngine::reset() {
+    for (auto& filter : splitter) filter.reset();
+    for (auto& filter : compensation) {
+        for (auto& allpass : filter) allpass.reset();
+    }
+    for (auto& blocker : dcBlocker) blocker.reset();
+}
+
+void DistortionEngine::setDCBlocker(bool shouldBlockDC) {
+    if (shouldBlockDC == isDCBlocking) return;
+    isDCBlocking = shouldBlockDC;
+    for (auto& blocker : dcBlocker) blocker.reset();
+}
+
+void DistortionEngine::setNumBands(int newNumBands) {
+    newNumBands = juce::jlimit(1, MaxBands, newNumBands);
+    if (newNumBands == numBands) return;
+    numBands = newNumBands;
+    reset();    // bands which were not in use hold stale state
+}
+
+void DistortionEngine::setCrossoverFrequency(int index, float frequency) {
+    crossoverFreq[index] = frequency;
+    updateCrossovers();
+}
+
+void DistortionEngine::updateCrossovers() {
+    float minFreq = 0.f;
+    for (int i = 0; i < MaxBands - 1; i++) {
+        const float frequency = juce::jmax(crossoverFreq[i], minFreq);
+        minFreq = frequency * MinCrossoverRatio;
+        splitter[i].setCutoffFrequency(frequency);
+        for (int band = 0; band < i && band < MaxBands - 2; band++) compensation[band][i].setCutoffFrequency(frequency);
+    }
+}
+
+void DistortionEngine::setMidSide(bool shouldUseMidSide) {
+    if (shouldUseMidSide == isMidSide) return;
+    isMidSide = shouldUseMidSide;
+    reset();    // crossover state belongs to the other representation
+}
+
+void DistortionEngine::process(const juce::dsp::ProcessContextReplacing<float>& context, const float* envelope) {
+    auto& block = context.getOutputBlock();
+    const int numChannels = (int)block.getNumChannels();
+    const int numSamples = (int)block.getNumSamples();
+    if (!isEnvelopeActive()) envelope = nullptr;
+
+    // the curve of each band is picked once per block; its loop is a template instance with the curve inlined
+    std::array<Kernels::ShapeBlock, MaxBands> shapeBlock, sideShapeBlock;
+    std::array<Kernels::ModulatedShapeBlock, MaxBands> modulatedShapeBlock, sideModulatedShapeBlock;
+    std::array<float, MaxBands> sideAmount;
+    for (int band = 0; band < numBands; band++) {
+        shapeBlock[band] = band == 0 ? Kernels::getShapeBlock<false>(waveShapeFunction[band], useFastMath)
+                                     : Kernels::getShapeBlock<true>(waveShapeFunction[band], useFastMath);
+        sideShapeBlock[band] = band == 0 ? Kernels::getShapeBlock<false>(sideWaveShapeFunction, useFastMath)
+                                         : Kernels::getShapeBlock<true>(sideWaveShapeFunction, useFastMath);
+        modulatedShapeBlock[band] = band == 0 ? Kernels::getShapeBlock<false, Kernels::PerSample>(waveShapeFunction[band], useFastMath)
+                                              : Kernels::getShapeBlock<true, Kernels::PerSample>(waveShapeFunction[band], useFastMath);
+        sideModulatedShapeBlock[band] = band == 0 ? Kernels::getShapeBlock<false, Kernels::PerSample>(sideWaveShapeFunction, useFastMath)
+                                                  : Kernels::getShapeBlock<true, Kernels::PerSample>(sideWaveShapeFunction, useFastMath);
+        sideAmount[band] = sideWaveShapeAmount;
+    }
+
+    if (!isMidSide || numChannels != 2) {
+        for (int channel = 0; channel < numChannels; channel++) {
+            float* samples = block.getChannelPointer(channel);
+            processChannel(channel, samples, samples, numSamples, shapeBlock.data(), modulatedShapeBlock.data(), waveShapeAmount.data(), 1.f, envelope);
+        }
+        return;
+    }
+
+    // mid/side: encoding is the first and decoding the last step per chunk, no extra passes over the buffer
+    float* left = block.getChannelPointer(0);
+    float* right = block.getChannelPointer(1);
+    for (int start = 0; start < numSamples; start += ChunkSize) {
+        const int length = std::min(ChunkSize, numSamples - start);
+        const float* chunkEnvelope = envelope != nullptr ? envelope + start : nullptr;
+        float mid[ChunkSize], side[ChunkSize];
+        for (int i = 0; i < length; i++) {
+            mid[i] = 0.5f * (left[start + i] + right[start + i]);
+            side[i] = 0.5f * (left[start + i] - right[start + i]);
+        }
+        processChannel(0, mid, mid, length, shapeBlock.data(), modulatedShapeBlock.data(), waveShapeAmount.data(), 1.f, chunkEnvelope);
+        processChannel(1, side, side, length, sideShapeBlock.data(), sideModulatedShapeBlock.data(), sideAmount.data(), sideGain, chunkEnvelope);
+        for (int i = 0; i < length; i++) {
+            left[start + i] = mid[i] + side[i];
+            right[start + i] = mid[i] - side[i];
+        }
+    }
+}
+
+void DistortionEngine::processChannel(int channel, const float* input, float* output, int numSamples, const Kernels::ShapeBlock* shapeBlock,
+                                      const Kernels::ModulatedShapeBlock* modulatedShapeBlock, const float* amount, float channelGain, const float* envelope) {
+    const int lastBand = numBands - 1;
+    Kernels::DCBlocker* blocker = isDCBlocking && channel < (int)dcBlocker.size() ? &dcBlocker[channel] : nullptr;
+    // the first band writes rather than adds to the output, so the scope reads its curve before the other bands follow
+    const bool isScoped = scope != nullptr && channel == 0;
+    const float firstBandGain = bandGain[0] * postGain * channelGain;
+    if (numBands == 1 && envelope == nullptr) {
+        if (isScoped) scope->captureInput(input, numSamples, Kernels::Constant{ preGain }, bias);
+        shapeBlock[0](input, output, numSamples, { amount[0] }, { preGain }, bias, firstBandGain, blocker);
+        if (isScoped) scope->pushOutput(output, numSamples, 1.f / firstBandGain);
+        return;
+    }
+
+    // per chunk: split into bands on the stack (multiband), then shape and sum the bands into the output
+    for (int start = 0; start < numSamples; start += ChunkSize) {
+        const int length = std::min(ChunkSize, numSamples - start);
+        float bandData[MaxBands][ChunkSize];
+        const float* bandInput[MaxBands] = { input + start };
+        if (numBands > 1) {
+            for (int i = 0; i < length; i++) {
+                float rest = input[start + i];
+                for (int band = 0; band < lastBand; band++) {
+                    float low, high;
+                    splitter[band].processSample(channel, rest, low, high);
+                    for (int crossover = band + 1; crossover < lastBand; crossover++) {
+                        low = compensation[band][crossover].processSample(channel, low);
+                    }
+                    bandData[band][i] = low;
+                    rest = high;
+                }
+                bandData[lastBand][i] = rest;
+            }
+            for (int band = 0; band < numBands; band++) bandInput[band] = bandData[band];
+        }
+
+        if (envelope == nullptr) {
+            if (isScoped) scope->captureInput(bandInput[0], length, Kernels::Constant{ preGain }, bias);
+            for (int band = 0; band < numBands; band++) {
+                shapeBlock[band](bandInput[band], output + start, length, { amount[band] }, { preGain }, bias, bandGain[band] * postGain * channelGain,
+                                 band == lastBand ? blocker : nullptr);
+                if (isScoped && band == 0) scope->pushOutput(output + start, length, 1.f / firstBandGain);
+            }
+            continue;
+        }
+
+        float drive[ChunkSize], modulatedAmount[ChunkSize];
+        for (int i = 0; i < length; i++) drive[i] = preGain * (1.f + (envelopeDrive * envelope[start + i]));
+        if (isScoped) scope->captureInput(bandInput[0], length, Kernels::PerSample{ drive }, bias);
+        for (int band = 0; band < numBands; band++) {
+            for (int i = 0; i < length; i++) {
+                modulatedAmount[i] = juce::jlimit(0.f, MaxAmount, amount[band] + (envelopeAmount * envelope[start + i]));
+            }
+            modulatedShapeBlock[band](bandInput[band], output + start, length, { modulatedAmount }, { drive }, bias, bandGain[band] * postGain * channelGain,
+                                      band == lastBand ? blocker : nullptr);
+            if (isScoped && band == 0) scope->pushOutput(output + start, length, 1.f / firstBandGain);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    DistortionEngine.h
+    Created: 19 Oct 2026 3:12:40pm
+    Author:  traxx
+
+    PreGain -> Bias -> WaveShaper -> PostGain, optionally split into up to four bands by a Linkwitz-Riley crossover
+    and/or into mid and side
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Chain.h"
+#include "WaveShaperKernels.h"
+#include "../Helpers/TransferScope.h"
+
+class DistortionEngine {
+public:
+    DistortionEngine();
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+    // envelope (optional, one value per sample of the block) modulates amount and pre-gain, see setEnvelopeAmount/-Drive
+    void process(const juce::dsp::ProcessContextReplacing<float>& context, const float* envelope = nullptr);
+
+    void setPreGain(float gainDecibels) { preGain = juce::Decibels::decibelsToGain(gainDecibels); }
+    void setBias(float newBias) { bias = newBias; }
+    void setPostGain(float gainDecibels) { postGain = juce::Decibels::decibelsToGain(gainDecibels); }
+    void setNumBands(int newNumBands);
+    void setCrossoverFrequency(int index, float frequency);
+    void setBandWaveShaper(int band, WaveShaperFunction function, float amount) { waveShapeFunction[band] = function; waveShapeAmount[band] = amount; }
+    void setBandGain(int band, float gainDecibels) { bandGain[band] = juce::Decibels::decibelsToGain(gainDecibels); }
+    void setUseFastMath(bool shouldUseFastMath) { useFastMath = shouldUseFastMath; }   // see FastMath.h for the error
+    void setMidSide(bool shouldUseMidSide);
+    void setSideWaveShaper(WaveShaperFunction function, float amount) { sideWaveShapeFunction = function; sideWaveShapeAmount = amount; }
+    void setSideGain(float gainDecibels) { sideGain = juce::Decibels::decibelsToGain(gainDecibels); }
+    void setEnvelopeAmount(float depth) { envelopeAmount = depth; }      // added to every waveshaper amount at envelope 1
+    void setEnvelopeDrive(float gainDecibels) { envelopeDrive = juce::Decibels::decibelsToGain(gainDecibels) - 1.f; }   // pre-gain boost at envelope 1
+    bool isEnvelopeActive() const { return envelopeAmount != 0.f || envelopeDrive > 0.f; }
+    void setDCBlocker(bool shouldBlockDC);      // after the bands are summed, see DCBlockerFrequency
+    // the first band's curve of channel 0 (left, or mid) is captured as it runs (with one band after the DC blocker);
+    // nullptr stops it
+    void setTransferScope(TransferScope* newScope) { scope = newScope; }
+
+private:
+    using Crossover = juce::dsp::LinkwitzRileyFilter<float>;
+    static constexpr float MinCrossoverRatio = 1.1f;     // keeps crossovers in ascending order
+    static constexpr int ChunkSize = 32;                // samples split into bands at once, small enough to stay in L1
+    static constexpr float MaxAmount = 0.99f;           // upper end of the WaveShapeAmount parameters
+
+    // band b is the lowpass output of splitter b (the last band the highpass of the last splitter);
+    // lower bands run through allpasses at every higher crossover so all bands sum back in phase
+    std::array<Crossover, MaxBands - 1> splitter;
+    std::array<std::array<Crossover, MaxBands - 1>, MaxBands - 2> compensation;     // [band][crossover]
+    std::array<float, MaxBands - 1> crossoverFreq{ 200.f, 1000.f, 5000.f };
+    void updateCrossovers();
+
+    // one channel (L, R, M or S), the crossovers keep their state per channel index
+    // with an envelope the modulated loops are used and processed in chunks, with the modulated values on the stack;
+    // the DC blocker runs in the loop of the last band
+    void processChannel(int channel, const float* input, float* output, int numSamples, const Kernels::ShapeBlock* shapeBlock,
+                        const Kernels::ModulatedShapeBlock* modulatedShapeBlock, const float* amount, float channelGain, const float* envelope);
+
+    int numBands = 1;
+    bool isMidSide = false;
+    bool useFastMath = false;
+    float preGain = 1.f, bias = 0.f, postGain = 1.f;
+    std::array<float, MaxBands> bandGain{ 1.f, 1.f, 1.f, 1.f };
+    std::array<float, MaxBands> waveShapeAmount{};
+    std::array<int, MaxBands> waveShapeFunction{};
+    float sideWaveShapeAmount = 0.f, sideGain = 1.f;     // in mid/side mode the main waveshaper settings are the mid's
+    int sideWaveShapeFunction = WaveShaperFunction::HardClip;
+    float envelopeAmount = 0.f, envelopeDrive = 0.f;
+    bool isDCBlocking = false;
+    std::vector<Kernels::DCBlocker> dcBlocker;      // per channel index, like the crossovers
+    TransferScope* scope = nullptr;
+};
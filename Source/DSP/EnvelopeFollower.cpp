@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    EnvelopeFollower.cpp
+    Created: 20 Oct 2026 5:21:02pm
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "EnvelopeFollower.h"
+
+void EnvelopeFollower::prepare(double newSampleRate, int maximumBlockSize) {
+    sampleRate = newSampleRate;
+    rectified.assign(maximumBlockSize, 0.f);
+    scratch.assign(maximumBlockSize, 0.f);
+    setAttack(attackMs);
+    setRelease(releaseMs);
+    reset();
+}
+
+void EnvelopeFollower::reset() {
+    state = 0.f;
+    lastOutput = 0.f;
+}
+
+void EnvelopeFollower::setAttack(float milliseconds) {
+    attackMs = milliseconds;
+    attackCoefficient = getCoefficient(milliseconds, sampleRate);
+}
+
+void EnvelopeFollower::setRelease(float milliseconds) {
+    releaseMs = milliseconds;
+    releaseCoefficient = getCoefficient(milliseconds, sampleRate);
+}
+
+void EnvelopeFollower::process(const float* const* channels, int numChannels, int numSamples, float* envelope) {
+    jassert(!rectified.empty());
+    const int capacity = (int)rectified.size();
+    for (int start = 0; start < numSamples; start += capacity) {    // hosts may exceed the announced block size
+        const int length = std::min(capacity, numSamples - start);
+        const float* segment[2] = { channels[0] + start, channels[std::min(1, numChannels - 1)] + start };
+        processSegment(segment, std::min(2, numChannels), length, envelope + start);
+    }
+}
+
+void EnvelopeFollower::processSegment(const float* const* channels, int numChannels, int numSamples, float* envelope) {
+    using namespace juce;
+    float* rect = rectified.data();
+
+    // detector input for the whole segment
+    if (detector == DetectorPeak) {
+        FloatVectorOperations::abs(rect, channels[0], numSamples);
+        if (numChannels > 1) {
+            FloatVectorOperations::abs(scratch.data(), channels[1], numSamples);
+            FloatVectorOperations::max(rect, rect, scratch.data(), numSamples);
+        }
+    } else {
+        FloatVectorOperations::multiply(rect, channels[0], channels[0], numSamples);
+        if (numChannels > 1) {
+            FloatVectorOperations::addWithMultiply(rect, channels[1], channels[1], numSamples);
+            FloatVectorOperations::multiply(rect, 0.5f, numSamples);
+        }
+    }
+
+    // ballistics once per step, linear interpolation of the output in between
+    for (int start = 0; start < numSamples; start += Step) {
+        const int length = std::min(Step, numSamples - start);
+        float target;
+        if (detector == DetectorPeak) target = FloatVectorOperations::findMaximum(rect + start, length);
+        else {
+            float sum = 0.f;
+            for (int i = 0; i < length; i++) sum += rect[start + i];
+            target = sum / length;
+        }
+        state = target + ((target > state ? attackCoefficient : releaseCoefficient) * (state - target));
+
+        const float output = detector == DetectorPeak ? state : std::sqrt(state);
+        const float increment = (output - lastOutput) / length;
+        for (int i = 0; i < length; i++) envelope[start + i] = lastOutput + (increment * (i + 1));
+        lastOutput = output;
+    }
+}
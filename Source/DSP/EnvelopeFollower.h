@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    EnvelopeFollower.h
+    Created: 20 Oct 2026 5:20:44pm
+    Author:  traxx
+
+    Stereo-linked peak/RMS envelope for the dynamic drive. Rectifying and combining the channels runs as vector
+    operations over the block; attack/release run once per Step samples and the envelope is interpolated in between
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+enum EnvelopeDetector {
+    DetectorPeak,
+    DetectorRMS
+};
+
+class EnvelopeFollower {
+public:
+    void prepare(double sampleRate, int maximumBlockSize);
+    void reset();
+
+    void setAttack(float milliseconds);
+    void setRelease(float milliseconds);
+    void setDetector(EnvelopeDetector newDetector) { detector = newDetector; }
+
+    // writes the linear envelope (of the louder channel for peak, of the channel mean for RMS) to envelope[0, numSamples)
+    void process(const float* const* channels, int numChannels, int numSamples, float* envelope);
+    float getCurrentValue() const { return lastOutput; }     // last sample of the last processed block
+
+private:
+    static constexpr int Step = 8;
+
+    void processSegment(const float* const* channels, int numChannels, int numSamples, float* envelope);
+    static float getCoefficient(float milliseconds, double sampleRate) {
+        return (float)std::exp(-Step / (milliseconds * 0.001 * sampleRate));
+    }
+
+    EnvelopeDetector detector = DetectorPeak;
+    double sampleRate = 44100.0;
+    float attackMs = 10.f, releaseMs = 100.f;
+    float attackCoefficient = 0.f, releaseCoefficient = 0.f;
+    float state = 0.f;          // peak level or mean square, depending on the detector
+    float lastOutput = 0.f;
+    std::vector<float> rectified, scratch;
+};
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+    Created: 20 Oct 2026 10:14:37am
+    Author:  traxx
+
+    Math policies for the waveshaper kernels: ExactMath uses the standard library, FastMath polynomial approximations.
+    FastMath::log2 is used on its own by the analyzer's dB conversion
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct ExactMath {
+    static float sin(float x) { return std::sin(x); }
+    static float cos(float x) { return std::cos(x); }
+};
+
+// Branch-free, so loops using it can still be vectorized. The argument is reduced to [-pi, pi] with a three-part 2 pi,
+// folded to [-pi/2, pi/2] and evaluated with an odd degree 9 minimax polynomial. The reduction is exact up to
+// MaxArgument, larger arguments are clamped to it (NaN stays NaN). Max. absolute error against double precision
+// sin/cos of the float argument: 4e-7 over the whole range. The curves' largest arguments at 0 dBFS input are about
+// 63000 ("Sin" at +32 dB pre-gain, +24 dB envelope drive and amount 0.99), so inputs up to +16 dBFS stay exact.
+struct FastMath {
+    static float sin(float x) { return sinReduced(reduce(x)); }
+    static float cos(float x) { return sinReduced(reduce(x) + juce::MathConstants<float>::halfPi); }   // cos(x) = sin(x + pi/2), shifted after reducing
+
+    // For positive, normal x: the exponent is taken from the bits, the mantissa m in [1, 2) goes through a degree 5
+    // polynomial in m - 1 (zero at m = 1, so exact powers of two stay exact). Max. absolute error 2e-5, 1e-4 dB in 20 log10.
+    // 0 gives -127 and denormals slightly more; callers clamp to their floor anyway. Negative x is not meaningful.
+    static float log2(float x) {
+        juce::uint32 bits;
+        std::memcpy(&bits, &x, sizeof(float));
+        const float exponent = (float)((int)(bits >> 23) - 127);
+        bits = (bits & 0x007fffffu) | 0x3f800000u;     // same mantissa, exponent 0
+        float t;
+        std::memcpy(&t, &bits, sizeof(float));
+        t -= 1.f;
+        return exponent + t * (1.4418798958f + t * (-0.7088652177f + t * (0.4152455604f
+                             + t * (-0.1935165246f + t * 0.0452682926f))));
+    }
+
+    static constexpr float MaxArgument = 400000.f;     // 2^16 turns
+
+private:
+    static float reduce(float x) {      // to [-pi, pi]
+        // 2 pi split in two parts of at most 8 significant bits and the rest, so k * twoPiHi and k * twoPiMid are exact for |k| < 2^16
+        constexpr float twoPiHi = 6.28125f, twoPiMid = 0.0019378662109375f, twoPiLo = -2.559031351268004e-06f;
+        constexpr float roundingOffset = 12582912.f;   // 1.5 * 2^23: adding and subtracting it rounds to an integer, no int cast
+        x = juce::jlimit(-MaxArgument, MaxArgument, x);
+        const float k = ((x * (1.f / juce::MathConstants<float>::twoPi)) + roundingOffset) - roundingOffset;
+        return ((x - (k * twoPiHi)) - (k * twoPiMid)) - (k * twoPiLo);
+    }
+    static float sinReduced(float r) {  // valid for |r| <= 3/2 pi
+        const float a = std::abs(r);
+        const float f = std::copysign(1.f, r) * (juce::MathConstants<float>::halfPi - std::abs(juce::MathConstants<float>::halfPi - a));  // sin(pi - a) = sin(a)
+        const float f2 = f * f;
+        return f * (0.99999997659f + f2 * (-0.16666647635f + f2 * (0.0083328998234f
+                  + f2 * (-0.00019800897763f + f2 * 0.0000025904885015f))));
+    }
+};
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    LinearPhaseFilter.cpp
+    Created: 19 Oct 2026 1:48:10pm
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "LinearPhaseFilter.h"
+
+LinearPhaseFilter::LinearPhaseFilter(const juce::AudioProcessorValueTreeState& apvts) : apvts(apvts) {}
+
+LinearPhaseFilter::~LinearPhaseFilter() {
+    worker->remove(*this);
+}
+
+void LinearPhaseFilter::prepare(const juce::dsp::ProcessSpec& spec) {
+    worker->remove(*this);
+
+    // the longer the FIR, the lower the frequencies it can shape; kept at the same resolution in Hz for higher rates
+    sampleRate = spec.sampleRate;
+    const int order = sampleRate <= 48000.0 ? 12 : (sampleRate <= 96000.0 ? 13 : 14);
+    firSize = 1 << order;
+    latency = firSize / 2;
+    fft = std::make_unique<juce::dsp::FFT>(order);
+    window = std::make_unique<juce::dsp::WindowingFunction<float>>(firSize, juce::dsp::WindowingFunction<float>::blackman, false);
+    fftData.assign(firSize * 2, 0.f);
+
+    convolution.prepare((int)spec.numChannels, firSize);
+    design(getChainSettings(apvts));
+    convolution.loadImpulseResponse(fftData.data());
+    isUpdateDeferred = false;
+
+    worker->add(*this);
+}
+
+void LinearPhaseFilter::reset() {
+    convolution.reset();
+    requestDeferredUpdate();
+}
+
+void LinearPhaseFilter::process(const juce::dsp::ProcessContextReplacing<float>& context) {
+    convolution.process(context.getOutputBlock());
+    requestDeferredUpdate();
+}
+
+// audio thread; once the queued response is taken, a design which had to wait is requested again
+void LinearPhaseFilter::requestDeferredUpdate() {
+    if (convolution.canQueue() && isUpdateDeferred.load() && isUpdateDeferred.exchange(false)) worker->request(*this);
+}
+
+void LinearPhaseFilter::runTask() {
+    const ChainSettings chainSettings = getChainSettings(apvts);
+    if (!chainSettings.LinearPhase || !filtersDiffer(chainSettings, designedSettings)) return;
+    if (!convolution.canQueue()) {
+        isUpdateDeferred = true;    // checked again after setting it, in case the audio thread took the response meanwhile
+        if (!convolution.canQueue() || !isUpdateDeferred.exchange(false)) return;
+    }
+    design(chainSettings);
+    convolution.queueImpulseResponse(fftData.data());
+}
+
+bool LinearPhaseFilter::dependsOn(int parameterIndex) {
+    switch (parameterIndex) {
+        case PosLoCutFreq: case PosLoCutSlope: case PosPeakFreq: case PosPeakGain: case PosPeakQ:
+        case PosHiCutFreq: case PosHiCutSlope: case PosLinearPhase:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool LinearPhaseFilter::filtersDiffer(const ChainSettings& a, const ChainSettings& b) {
+    return a.LoCutFreq != b.LoCutFreq || a.LoCutSlope != b.LoCutSlope
+        || a.PeakFreq != b.PeakFreq || a.PeakGain != b.PeakGain || a.PeakQ != b.PeakQ
+        || a.HiCutFreq != b.HiCutFreq || a.HiCutSlope != b.HiCutSlope;
+}
+
+void LinearPhaseFilter::design(const ChainSettings& chainSettings) {
+    updateLoCutFilter(designChain.get<ChainPositions::LoCut>(), chainSettings, sampleRate);
+    updatePeakFilter(designChain.get<ChainPositions::Peak>(), chainSettings, sampleRate);
+    updateHiCutFilter(designChain.get<ChainPositions::HiCut>(), chainSettings, sampleRate);
+
+    // magnitude of the IIR chain per bin, phase of a pure delay of N/2 samples: e^(-j*pi*k) = (-1)^k
+    std::fill(fftData.begin(), fftData.end(), 0.f);
+    for (int bin = 0; bin <= firSize / 2; bin++) {
+        const double freq = bin * sampleRate / firSize;
+        const double mag = getFilterMagnitudeForFrequency(designChain, freq, sampleRate);
+        fftData[bin * 2] = (float)((bin % 2 == 0) ? mag : -mag);
+    }
+    fft->performRealOnlyInverseTransform(fftData.data());
+    window->multiplyWithWindowingTable(fftData.data(), firSize);   // smooths the truncation of the response at both ends
+    designedSettings = chainSettings;
+}
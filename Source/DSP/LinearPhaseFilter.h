@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+
+    LinearPhaseFilter.h
+    Created: 19 Oct 2026 1:47:52pm
+    Author:  traxx
+
+    FIR counterpart of the LoCut/Peak/HiCut filters: same magnitude response, no phase shift, N/2 samples latency
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Chain.h"
+#include "PartitionedConvolution.h"
+#include "../Helpers/BackgroundWorker.h"
+
+class LinearPhaseFilter : private BackgroundWorker::Task {
+public:
+    LinearPhaseFilter(const juce::AudioProcessorValueTreeState& apvts);
+    ~LinearPhaseFilter() override;
+
+    // designs the first impulse response synchronously, so the first block is filtered already; afterwards it is
+    // regenerated in the background on requestUpdate
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void requestUpdate() { worker->request(*this); }     // any thread; for changes of the parameters in dependsOn
+    static bool dependsOn(int parameterIndex);
+    void reset();
+    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+    int getLatency() const { return latency; }
+
+private:
+    void runTask() override;
+    void design(const ChainSettings& chainSettings);   // into the first firSize values of fftData
+    void requestDeferredUpdate();
+    static bool filtersDiffer(const ChainSettings& a, const ChainSettings& b);
+
+    const juce::AudioProcessorValueTreeState& apvts;
+    juce::SharedResourcePointer<BackgroundWorker> worker;
+    PartitionedConvolution convolution;     // zero latency on top of the FIR's own
+    std::atomic<bool> isUpdateDeferred{ false };    // a design waits for the convolution to take the last one
+
+    MonoChain designChain;          // only the filter stages are used, to get their magnitude response
+    ChainSettings designedSettings;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    std::vector<float> fftData;
+    double sampleRate = 44100.0;
+    int firSize = 0;
+    int latency = 0;
+};
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.cpp
+    Created: 20 Oct 2026 7:42:35pm
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "ModulationMatrix.h"
+
+ModulationMatrix::ModulationMatrix(const juce::AudioProcessorValueTreeState& apvts) {
+    for (int i = 0; i < NumModulationTargets; i++) targetRange[i] = apvts.getParameterRange(ModulationTargets[i].id);
+}
+
+juce::StringArray ModulationMatrix::getTargetOptions() {
+    juce::StringArray options{ "None" };
+    for (const auto& target : ModulationTargets) options.add(target.id);
+    return options;
+}
+
+void ModulationMatrix::prepare(double newSampleRate) {
+    sampleRate = newSampleRate;
+    beatsPerSample = DefaultBpm / (60.0 * sampleRate);
+    reset();
+}
+
+void ModulationMatrix::reset() {
+    blockStartBeat = 0.0;
+    freeRunningBeat = 0.0;
+}
+
+void ModulationMatrix::beginBlock(juce::AudioPlayHead* playHead, int numSamples) {
+    double bpm = DefaultBpm;
+    juce::Optional<double> hostBeat;
+    if (playHead != nullptr) {
+        if (const auto position = playHead->getPosition()) {
+            if (const auto hostBpm = position->getBpm()) bpm = *hostBpm;
+            if (position->getIsPlaying()) hostBeat = position->getPpqPosition();
+        }
+    }
+    beatsPerSample = bpm / (60.0 * sampleRate);
+    blockStartBeat = hostBeat ? *hostBeat : freeRunningBeat;
+    freeRunningBeat = blockStartBeat + (numSamples * beatsPerSample);
+}
+
+bool ModulationMatrix::isActive(const ChainSettings& chainSettings) const {
+    for (int slot = 0; slot < NumModulationSlots; slot++) {
+        if (isSlotActive(chainSettings, slot)) return true;
+    }
+    return false;
+}
+
+bool ModulationMatrix::usesEnvelope(const ChainSettings& chainSettings) const {
+    for (int slot = 0; slot < NumModulationSlots; slot++) {
+        if (isSlotActive(chainSettings, slot) && chainSettings.ModSource[slot] == SourceEnvelope) return true;
+    }
+    return false;
+}
+
+void ModulationMatrix::apply(ChainSettings& chainSettings, int sampleOffset, float envelope) const {
+    const double beat = blockStartBeat + (sampleOffset * beatsPerSample);
+    for (int slot = 0; slot < NumModulationSlots; slot++) {
+        if (!isSlotActive(chainSettings, slot)) continue;
+
+        float value;    // LFOs are bipolar, the envelope unipolar
+        const int source = chainSettings.ModSource[slot];
+        if (source == SourceEnvelope) value = juce::jlimit(0.f, 1.f, envelope);
+        else {
+            const int lfo = source - SourceLFO1;
+            const double cycles = beat / BeatsPerCycle[chainSettings.LFORate[lfo]];
+            value = getLFOValue(chainSettings.LFOShape[lfo], cycles - std::floor(cycles));
+        }
+
+        // offset in the normalised range, so the depth means the same for frequencies, gains and amounts
+        const int target = chainSettings.ModTarget[slot] - 1;
+        float* targetValue = getTargetValue(chainSettings, ModulationTargets[target].parameter);
+        const auto& range = targetRange[target];
+        *targetValue = range.convertFrom0to1(juce::jlimit(0.f, 1.f, range.convertTo0to1(*targetValue) + (chainSettings.ModDepth[slot] * value)));
+    }
+}
+
+float ModulationMatrix::getLFOValue(int shape, double phase) {
+    switch (shape) {
+        case ShapeSine: return (float)std::sin(phase * juce::MathConstants<double>::twoPi);
+        case ShapeTriangle: return (float)(1.0 - (4.0 * std::abs(phase - 0.5)));
+        case ShapeSaw: return (float)((2.0 * phase) - 1.0);
+        case ShapeSquare: return phase < 0.5 ? 1.f : -1.f;
+    }
+    return 0.f;
+}
+
+float* ModulationMatrix::getTargetValue(ChainSettings& chainSettings, TreeParameter parameter) {
+    switch (parameter) {
+        case PosLoCutFreq: return &chainSettings.LoCutFreq;
+        case PosPeakFreq: return &chainSettings.PeakFreq;
+        case PosPeakGain: return &chainSettings.PeakGain;
+        case PosPeakQ: return &chainSettings.PeakQ;
+        case PosHiCutFreq: return &chainSettings.HiCutFreq;
+        case PosPreGain: return &chainSettings.PreGain;
+        case PosBias: return &chainSettings.Bias;
+        case PosWaveShapeAmount: return &chainSettings.WaveShapeAmount[0];
+        case PosPostGain: return &chainSettings.PostGain;
+        case PosCrossoverFreq1: return &chainSettings.CrossoverFreq[0];
+        case PosCrossoverFreq2: return &chainSettings.CrossoverFreq[1];
+        case PosCrossoverFreq3: return &chainSettings.CrossoverFreq[2];
+        case PosBand1Gain: return &chainSettings.BandGain[0];
+        case PosBand2WaveShapeAmount: return &chainSettings.WaveShapeAmount[1];
+        case PosBand2Gain: return &chainSettings.BandGain[1];
+        case PosBand3WaveShapeAmount: return &chainSettings.WaveShapeAmount[2];
+        case PosBand3Gain: return &chainSettings.BandGain[2];
+        case PosBand4WaveShapeAmount: return &chainSettings.WaveShapeAmount[3];
+        case PosBand4Gain: return &chainSettings.BandGain[3];
+        case PosSideWaveShapeAmount: return &chainSettings.SideWaveShapeAmount;
+        case PosSideGain: return &chainSettings.SideGain;
+        case PosEnvAmount: return &chainSettings.EnvAmount;
+        case PosEnvDrive: return &chainSettings.EnvDrive;
+        case PosEnvAttack: return &chainSettings.EnvAttack;
+        case PosEnvRelease: return &chainSettings.EnvRelease;
+        default: break;
+    }
+    jassertfalse;   // not in ModulationTargets
+    return &chainSettings.PreGain;
+}
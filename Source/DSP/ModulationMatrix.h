@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.h
+    Created: 20 Oct 2026 7:42:18pm
+    Author:  traxx
+
+    Tempo-synced LFOs and the envelope follower routed to continuous parameters. Evaluated at control rate on the
+    audio thread: the processor applies it to the settings of every sub-block before they reach updateSettings
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Chain.h"
+
+// parameters a modulation slot can target, "ModNTarget" choice index - 1
+struct ModulationTarget {
+    TreeParameter parameter;
+    const char* id;
+};
+constexpr ModulationTarget ModulationTargets[] = {
+    { PosLoCutFreq, "LoCutFreq" }, { PosPeakFreq, "PeakFreq" }, { PosPeakGain, "PeakGain" }, { PosPeakQ, "PeakQ" }, { PosHiCutFreq, "HiCutFreq" },
+    { PosPreGain, "PreGain" }, { PosBias, "Bias" }, { PosWaveShapeAmount, "WaveShapeAmount" }, { PosPostGain, "PostGain" },
+    { PosCrossoverFreq1, "CrossoverFreq1" }, { PosCrossoverFreq2, "CrossoverFreq2" }, { PosCrossoverFreq3, "CrossoverFreq3" },
+    { PosBand1Gain, "Band1Gain" }, { PosBand2WaveShapeAmount, "Band2WaveShapeAmount" }, { PosBand2Gain, "Band2Gain" },
+    { PosBand3WaveShapeAmount, "Band3WaveShapeAmount" }, { PosBand3Gain, "Band3Gain" },
+    { PosBand4WaveShapeAmount, "Band4WaveShapeAmount" }, { PosBand4Gain, "Band4Gain" },
+    { PosSideWaveShapeAmount, "SideWaveShapeAmount" }, { PosSideGain, "SideGain" },
+    { PosEnvAmount, "EnvAmount" }, { PosEnvDrive, "EnvDrive" }, { PosEnvAttack, "EnvAttack" }, { PosEnvRelease, "EnvRelease" }
+};
+constexpr int NumModulationTargets = (int)(sizeof(ModulationTargets) / sizeof(ModulationTargets[0]));
+
+class ModulationMatrix {
+public:
+    explicit ModulationMatrix(const juce::AudioProcessorValueTreeState& apvts);
+
+    static juce::StringArray getTargetOptions();    // "None" and the IDs of ModulationTargets
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // once per block, before apply(); LFOs follow the host's beat position while it plays and run freely otherwise
+    void beginBlock(juce::AudioPlayHead* playHead, int numSamples);
+
+    bool isActive(const ChainSettings& chainSettings) const;
+    bool usesEnvelope(const ChainSettings& chainSettings) const;
+
+    // offsets the targets in chainSettings by the sources' values at sampleOffset into the block; envelope is linear
+    void apply(ChainSettings& chainSettings, int sampleOffset, float envelope) const;
+
+private:
+    static constexpr double DefaultBpm = 120.0;
+    static constexpr double BeatsPerCycle[] = { 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0 };     // LFORateOptions
+
+    static float getLFOValue(int shape, double phase);
+    static float* getTargetValue(ChainSettings& chainSettings, TreeParameter parameter);
+    bool isSlotActive(const ChainSettings& chainSettings, int slot) const {
+        return chainSettings.ModSource[slot] != SourceNone && chainSettings.ModTarget[slot] > 0 && chainSettings.ModDepth[slot] != 0.f;
+    }
+
+    std::array<juce::NormalisableRange<float>, NumModulationTargets> targetRange;     // copied once, read on the audio thread
+    double sampleRate = 44100.0;
+    double beatsPerSample = 0.0;
+    double blockStartBeat = 0.0, freeRunningBeat = 0.0;
+};
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolution.cpp
+    Created: 21 Oct 2026 6:03:12am
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "PartitionedConvolution.h"
+
+// sum += a * b, per interleaved complex bin
+static void multiplyAdd(float* sum, const float* a, const float* b, int numFloats) {
+    for (int i = 0; i < numFloats; i += 2) {
+        sum[i] += (a[i] * b[i]) - (a[i + 1] * b[i + 1]);
+        sum[i + 1] += (a[i] * b[i + 1]) + (a[i + 1] * b[i]);
+    }
+}
+
+void PartitionedConvolution::prepare(int numChannels, int impulseResponseSize) {
+    jassert(impulseResponseSize > 0 && impulseResponseSize % PartitionSize == 0);
+    numPartitions = impulseResponseSize / PartitionSize;
+    for (auto& spectra : impulseSpectra) spectra.assign((size_t)(numPartitions * SpectrumFloats), 0.f);
+    front = &impulseSpectra[0];
+    back = &impulseSpectra[1];
+    state = Idle;
+    isCrossfading = false;
+    fftBuffer.assign(FFTFloats, 0.f);
+    queueBuffer.assign(FFTFloats, 0.f);
+
+    channels.resize((size_t)numChannels);
+    for (auto& channel : channels) {
+        channel.segment.assign(PartitionSize, 0.f);
+        channel.spectrum.assign(SpectrumFloats, 0.f);
+        channel.history.assign((size_t)(numPartitions * SpectrumFloats), 0.f);
+        channel.tail.assign(SpectrumFloats, 0.f);
+        channel.tailNext.assign(SpectrumFloats, 0.f);
+        channel.rendered.assign(FFTFloats, 0.f);
+        channel.renderedNext.assign(FFTFloats, 0.f);
+        channel.overlap.assign(PartitionSize, 0.f);
+        channel.overlapNext.assign(PartitionSize, 0.f);
+    }
+    reset();
+}
+
+void PartitionedConvolution::loadImpulseResponse(const float* impulseResponse) {
+    transformPartitions(impulseResponse, *front);
+    for (auto& channel : channels) sumTail(channel, *front, 1, channel.tail);
+}
+
+void PartitionedConvolution::queueImpulseResponse(const float* impulseResponse) {
+    jassert(canQueue());
+    transformPartitions(impulseResponse, *back);
+    state.store(Ready, std::memory_order_release);
+}
+
+void PartitionedConvolution::transformPartitions(const float* impulseResponse, std::vector<float>& spectra) {
+    for (int partition = 0; partition < numPartitions; partition++) {
+        std::fill(queueBuffer.begin(), queueBuffer.end(), 0.f);
+        std::copy(impulseResponse + (partition * PartitionSize), impulseResponse + ((partition + 1) * PartitionSize), queueBuffer.begin());
+        queueFFT.performRealOnlyForwardTransform(queueBuffer.data(), true);
+        std::copy(queueBuffer.begin(), queueBuffer.begin() + SpectrumFloats, spectra.begin() + (partition * SpectrumFloats));
+    }
+}
+
+void PartitionedConvolution::reset() {
+    if (state.load(std::memory_order_acquire) == Ready) {   // nothing to crossfade from
+        std::swap(front, back);
+        state.store(Idle, std::memory_order_release);
+    }
+    isCrossfading = false;
+    position = 0;
+    historyIndex = 0;
+    for (auto& channel : channels) {
+        std::fill(channel.segment.begin(), channel.segment.end(), 0.f);
+        std::fill(channel.history.begin(), channel.history.end(), 0.f);
+        std::fill(channel.tail.begin(), channel.tail.end(), 0.f);
+        std::fill(channel.overlap.begin(), channel.overlap.end(), 0.f);
+    }
+}
+
+void PartitionedConvolution::process(const juce::dsp::AudioBlock<float>& block) {
+    const int numChannels = juce::jmin((int)block.getNumChannels(), (int)channels.size());
+    const int numSamples = (int)block.getNumSamples();
+    for (int start = 0; start < numSamples;) {
+        if (position == 0 && !isCrossfading && state.load(std::memory_order_acquire) == Ready) {
+            isCrossfading = true;
+            for (int ch = 0; ch < numChannels; ch++) beginCrossfade(channels[ch]);
+        }
+        const int length = juce::jmin(PartitionSize - position, numSamples - start);
+        for (int ch = 0; ch < numChannels; ch++) processSegment(channels[ch], block.getChannelPointer(ch) + start, length);
+        position += length;
+        start += length;
+
+        if (position == PartitionSize) {
+            const bool wasCrossfading = isCrossfading;
+            if (isCrossfading) {
+                std::swap(front, back);
+                isCrossfading = false;
+                state.store(Idle, std::memory_order_release);
+            }
+            historyIndex = (historyIndex + 1) % numPartitions;
+            for (int ch = 0; ch < numChannels; ch++) endSegment(channels[ch], wasCrossfading ? channels[ch].renderedNext : channels[ch].rendered);
+            position = 0;
+        }
+    }
+}
+
+void PartitionedConvolution::processSegment(Channel& channel, float* data, int length) {
+    std::copy(data, data + length, channel.segment.begin() + position);
+    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.f);
+    std::copy(channel.segment.begin(), channel.segment.end(), fftBuffer.begin());
+    fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+    std::copy(fftBuffer.begin(), fftBuffer.begin() + SpectrumFloats, channel.spectrum.begin());
+
+    render(channel, *front, channel.tail, channel.rendered);
+    const float* rendered = channel.rendered.data() + position;
+    const float* overlap = channel.overlap.data() + position;
+    if (!isCrossfading) {
+        for (int i = 0; i < length; i++) data[i] = rendered[i] + overlap[i];
+        return;
+    }
+    render(channel, *back, channel.tailNext, channel.renderedNext);
+    const float* renderedNext = channel.renderedNext.data() + position;
+    const float* overlapNext = channel.overlapNext.data() + position;
+    for (int i = 0; i < length; i++) {
+        const float current = rendered[i] + overlap[i];
+        const float next = renderedNext[i] + overlapNext[i];
+        data[i] = current + ((next - current) * ((float)(position + i) / PartitionSize));
+    }
+}
+
+// output of the current segment so far (first half) and what it adds to the next one (second half)
+void PartitionedConvolution::render(const Channel& channel, const std::vector<float>& spectra, const std::vector<float>& tail, std::vector<float>& rendered) {
+    std::copy(tail.begin(), tail.end(), rendered.begin());
+    multiplyAdd(rendered.data(), channel.spectrum.data(), spectra.data(), SpectrumFloats);
+    fft.performRealOnlyInverseTransform(rendered.data());
+}
+
+// partitions from firstPartition on, each with the segment as many segments back from the newest complete one
+void PartitionedConvolution::sumTail(const Channel& channel, const std::vector<float>& spectra, int firstPartition, std::vector<float>& sum) const {
+    std::fill(sum.begin(), sum.begin() + SpectrumFloats, 0.f);
+    for (int partition = firstPartition; partition < numPartitions; partition++) {
+        const int segment = (historyIndex - (partition - firstPartition) + numPartitions) % numPartitions;
+        multiplyAdd(sum.data(), channel.history.data() + (segment * SpectrumFloats), spectra.data() + (partition * SpectrumFloats), SpectrumFloats);
+    }
+}
+
+// the queued response takes over as if it had been running all along: its tail for the current segment and its
+// overlap from the previous one come from the history
+void PartitionedConvolution::beginCrossfade(Channel& channel) {
+    sumTail(channel, *back, 1, channel.tailNext);
+    sumTail(channel, *back, 0, channel.renderedNext);
+    fft.performRealOnlyInverseTransform(channel.renderedNext.data());
+    std::copy(channel.renderedNext.begin() + PartitionSize, channel.renderedNext.begin() + (2 * PartitionSize), channel.overlapNext.begin());
+}
+
+void PartitionedConvolution::endSegment(Channel& channel, const std::vector<float>& rendered) {
+    std::copy(rendered.begin() + PartitionSize, rendered.begin() + (2 * PartitionSize), channel.overlap.begin());
+    std::copy(channel.spectrum.begin(), channel.spectrum.end(), channel.history.begin() + (historyIndex * SpectrumFloats));
+    std::fill(channel.segment.begin(), channel.segment.end(), 0.f);
+    sumTail(channel, *front, 1, channel.tail);
+}
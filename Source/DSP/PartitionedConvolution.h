@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolution.h
+    Created: 21 Oct 2026 6:02:45am
+    Author:  traxx
+
+    Uniformly partitioned FFT convolution of all channels with one impulse response, without latency: the partition
+    being filled is transformed on every call, the complete ones only once. Replaces juce::dsp::Convolution, whose
+    impulse response only arrives asynchronously, through a message thread per instance
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class PartitionedConvolution {
+public:
+    static constexpr int PartitionSize = 512;
+
+    // allocates; impulseResponseSize is a multiple of PartitionSize
+    void prepare(int numChannels, int impulseResponseSize);
+    // takes effect immediately; not concurrently with process or queueImpulseResponse
+    void loadImpulseResponse(const float* impulseResponse);
+
+    // a queued impulse response is crossfaded in over the next partition; one background thread may queue while
+    // the audio thread processes, whenever canQueue
+    bool canQueue() const { return state.load(std::memory_order_acquire) == Idle; }
+    void queueImpulseResponse(const float* impulseResponse);
+
+    void reset();
+    void process(const juce::dsp::AudioBlock<float>& block);
+
+private:
+    static constexpr int FFTOrder = 10;                         // one partition, zero padded to twice its length
+    static constexpr int FFTFloats = 4 * PartitionSize;         // juce::dsp::FFT works in place on twice its size
+    static constexpr int SpectrumFloats = 2 * (PartitionSize + 1);  // interleaved complex bins up to Nyquist
+    enum QueueState { Idle, Ready };
+
+    struct Channel {
+        std::vector<float> segment;         // input of the partition being filled, zeros after the position
+        std::vector<float> spectrum;        // of segment
+        std::vector<float> history;         // spectra of the last numPartitions complete segments
+        std::vector<float> tail, tailNext;  // what the older segments add to the current one (queued response: Next)
+        std::vector<float> rendered, renderedNext;
+        std::vector<float> overlap, overlapNext;    // second half of the previous segment's output
+    };
+
+    void transformPartitions(const float* impulseResponse, std::vector<float>& spectra);
+    void processSegment(Channel& channel, float* data, int length);
+    void render(const Channel& channel, const std::vector<float>& spectra, const std::vector<float>& tail, std::vector<float>& rendered);
+    void sumTail(const Channel& channel, const std::vector<float>& spectra, int firstPartition, std::vector<float>& sum) const;
+    void beginCrossfade(Channel& channel);
+    void endSegment(Channel& channel, const std::vector<float>& rendered);
+
+    juce::dsp::FFT fft{ FFTOrder }, queueFFT{ FFTOrder };   // engines may keep work buffers, so one per thread
+    std::vector<float> fftBuffer, queueBuffer;
+    std::vector<float> impulseSpectra[2];
+    std::vector<float>* front = &impulseSpectra[0];     // the audio thread's
+    std::vector<float>* back = &impulseSpectra[1];      // the queueing thread's while Idle, crossfaded in when Ready
+    std::atomic<int> state{ Idle };
+    bool isCrossfading = false;
+
+    std::vector<Channel> channels;
+    int numPartitions = 0;
+    int position = 0;       // in the current segment, the same for all channels
+    int historyIndex = 0;   // of the newest complete segment
+};
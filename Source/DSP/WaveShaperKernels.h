@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    WaveShaperKernels.h
+    Created: 19 Oct 2026 4:36:05pm
+    Author:  traxx
+
+    One functor type per WaveShaperFunction; block loops are instantiated per curve and picked once per block.
+    The amount is a runtime input of the loops, as a scalar or as a per-sample buffer
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FastMath.h"
+
+namespace Kernels {
+    // values which only depend on the amount are computed once in the constructor, operator() is the per-sample curve;
+    // curves using trigonometry take the math policy (ExactMath / FastMath) as template parameter. With ExactMath every
+    // curve returns exactly what the closures it replaced did, so the operations keep their original order
+
+    struct HardClip {
+        explicit HardClip(float amount) : amount(amount), limit(1.f - amount) {}
+        float operator()(float x) const { return juce::jlimit(-limit, limit, x) + (x < 0 ? -amount : amount); }
+        float amount, limit;
+    };
+
+    struct SoftClip {   // x * sqrt(1+a²) - scaling factor 5
+        explicit SoftClip(float amount) : factor(std::sqrt(1 + ((amount * 5) * (amount * 5)))) {}
+        float operator()(float x) const { return juce::jlimit(-1.f, 1.f, x * factor); }
+        float factor;
+    };
+
+    template<typename Math>
+    struct Cracked {    // x³ * cos(x*a)³ - scaling factor 9.4
+        explicit Cracked(float amount) : amount(amount) {}
+        float operator()(float x) const {
+            const float c = Math::cos(x * amount * 9.4f);
+            if constexpr (std::is_same_v<Math, ExactMath>) return juce::jlimit(-1.f, 1.f, (float)(std::pow(x, 3) * std::pow(c, 3)));    // in double
+            else return juce::jlimit(-1.f, 1.f, x * x * x * c * c * c);
+        }
+        float amount;
+    };
+
+    struct GNOME {      // x - (a/x)
+        explicit GNOME(float amount) : amount(amount) {}
+        float operator()(float x) const { return juce::jlimit(-1.f, 1.f, x == 0 ? 0 : x - (amount / x)); }
+        float amount;
+    };
+
+    struct Warm {       // x < 0: x*a   --  x > 0: x*(1+a)
+        explicit Warm(float amount) : negative(1.f - amount), positive(1.f + amount) {}
+        float operator()(float x) const { return juce::jlimit(-1.f, 1.f, x * (x <= 0 ? negative : positive)); }
+        float negative, positive;
+    };
+
+    struct Quantize {
+        explicit Quantize(float amount) : numSteps(1 + (int)std::floor((1 / (amount + 0.01f)) * 2)), stepSize(1.f / numSteps) {}
+        float operator()(float x) const {
+            const int quant = std::min(numSteps, (int)(std::abs(x * numSteps)));
+            return juce::jlimit(-1.f, 1.f, x < 0 ? -(stepSize * quant) : (stepSize * quant));
+        }
+        int numSteps;
+        float stepSize;
+    };
+
+    template<typename Math>
+    struct Fuzz {       // x + (a * sin(10a * x))
+        explicit Fuzz(float amount) : amount(amount), frequency(10 * amount) {}
+        float operator()(float x) const { return juce::jlimit(-1.f, 1.f, x + (amount * Math::sin(frequency * x))); }
+        float amount, frequency;
+    };
+
+    template<typename Math>
+    struct Hollowing {  // x * (3a * sin(x)) - x - a
+        explicit Hollowing(float amount) : amount(amount), factor(3 * amount) {}
+        float operator()(float x) const { return juce::jlimit(-1.f, 1.f, x * (factor * Math::sin(x)) - x - amount); }
+        float amount, factor;
+    };
+
+    template<typename Math>
+    struct Sin {
+        explicit Sin(float amount) : amount(amount), factor(2 * amount), dry(1 - amount) {}
+        float operator()(float x) const { return juce::jlimit(-1.f, 1.f, factor * Math::sin(x * 100 * amount) + (dry * x)); }
+        float amount, factor, dry;
+    };
+
+    struct Rash {
+        //                                    -1           -0.8          -0.6          -0.4          -0.2           0            0.2           0.4           0.6           0.8           1
+        static constexpr float Noise[] = { 2.22f, 3.21f, 1.38f, 0.21f, 3.66f, 1.51f, 3.41f, 2.14f, 2.09f, 0.31f, 1.15f, 3.15f, 2.58f, 0.91f, 1.18f, 4.29f, 3.24f, 0.11f, 0.05f, 2.11f, 1.77f };
+        static constexpr float Steps[] = { -0.9f, -0.8f, -0.7f, -0.6f, -0.5f, -0.4f, -0.3f, -0.2f, -0.1f, 0.f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.f };
+        explicit Rash(float amount) : amount(amount), dry(1.f - amount) {}
+        float operator()(float x) const {
+            // the noise value of the first step x is below, counted without branches; NaN counts all steps, like the
+            // original chain of x < step tests
+            int index = 0;
+            for (const float step : Steps) index += !(x < step);
+            return juce::jlimit(-1.f, 1.f, (Noise[index] * x * amount) + (x * dry));
+        }
+        float amount, dry;
+    };
+
+    template<typename Math>
+    struct Spiked {
+        static constexpr float Pi3p16 = 3 * 3.14159f / 16;
+        explicit Spiked(float amount) : amount(amount), dry(1.f - amount) {}
+        float operator()(float x) const {
+            if (x < -Pi3p16) return juce::jlimit(-1.f, 1.f, amount + (x * dry));
+            if (x < 0) return juce::jlimit(-1.f, 1.f, (Math::sin(8 * x) * amount) + (x * dry));
+            if (x < 0.25f) return juce::jlimit(-1.f, 1.f, ((Math::sin(10 * x) + 0.25f) * amount) + (x * dry));
+            if (x < 0.5f) return juce::jlimit(-1.f, 1.f, ((Math::sin(10 * x + 1) + 0.25f) * amount) + (x * dry));
+            if (x < 0.75f) return juce::jlimit(-1.f, 1.f, ((Math::sin(10 * x + 2) + 0.25f) * amount) + (x * dry));
+            return juce::jlimit(-1.f, 1.f, x * dry + amount);
+        }
+        float amount, dry;
+    };
+
+    struct Titruff {
+        explicit Titruff(float amount) : amount(amount), dry(1.f - amount) {}
+        float operator()(float x) const {
+            if (x > -0.162f && x < 0.162f) return ((-10.f * x * x + 1) * amount) + (x * dry);
+            return juce::jlimit(-1.f, 1.f, ((-0.5f * x * x + 0.75f) * amount) + (x * dry));
+        }
+        float amount, dry;
+    };
+
+    //==============================================================================
+    // amount and pre-gain of a block loop come either as one value or as one value per sample; kernels are built
+    // from the amount, either once per block or per sample (cheap for all curves), never as function objects
+    struct Constant {
+        float value;
+        float operator[](int) const { return value; }
+    };
+    struct PerSample {
+        const float* values;
+        float operator[](int i) const { return values[i]; }
+    };
+
+    // one pole highpass, y = x - x[-1] + r * y[-1]; state of one channel
+    struct DCBlocker {
+        void prepare(double sampleRate, float frequency) {
+            coefficient = (float)std::exp(-juce::MathConstants<double>::twoPi * frequency / sampleRate);
+            reset();
+        }
+        void reset() { lastInput = 0.f; lastOutput = 0.f; }
+        float coefficient = 0.f, lastInput = 0.f, lastOutput = 0.f;
+    };
+
+    // output = gain * curve(input * preGain + bias), written or added to output (output may alias input when writing);
+    // with a DC blocker (the last band of a channel) the result is filtered in the same loop, after the accumulation
+    template<typename Source>
+    using ShapeBlockFor = void (*)(const float* input, float* output, int numSamples, Source amount, Source preGain, float bias, float gain, DCBlocker* dcBlocker);
+    using ShapeBlock = ShapeBlockFor<Constant>;
+    using ModulatedShapeBlock = ShapeBlockFor<PerSample>;
+
+    template<typename Kernel, bool Accumulate, typename Source>
+    void shapeBlock(const float* input, float* output, int numSamples, Source amount, Source preGain, float bias, float gain, DCBlocker* dcBlocker) {
+        constexpr int StepSize = 64;
+        float shaped[StepSize];     // the curve's result is stored as is, compilers can't turn its clipping into min/max otherwise
+        float lastInput = 0.f, lastOutput = 0.f;
+        if (dcBlocker != nullptr) {
+            lastInput = dcBlocker->lastInput;
+            lastOutput = dcBlocker->lastOutput;
+        }
+        for (int start = 0; start < numSamples; start += StepSize) {
+            const int length = std::min(StepSize, numSamples - start);
+            if constexpr (std::is_same_v<Source, Constant>) {
+                const Kernel kernel(amount.value);
+                for (int i = 0; i < length; i++) shaped[i] = kernel((input[start + i] * preGain.value) + bias);
+            } else {
+                for (int i = 0; i < length; i++) shaped[i] = Kernel(amount[start + i])((input[start + i] * preGain[start + i]) + bias);
+            }
+            if (dcBlocker == nullptr) {
+                for (int i = 0; i < length; i++) output[start + i] = Accumulate ? output[start + i] + (shaped[i] * gain) : shaped[i] * gain;
+                continue;
+            }
+            for (int i = 0; i < length; i++) {
+                const float x = Accumulate ? output[start + i] + (shaped[i] * gain) : shaped[i] * gain;
+                lastOutput = x - lastInput + (dcBlocker->coefficient * lastOutput);
+                lastInput = x;
+                output[start + i] = lastOutput;
+            }
+        }
+        if (dcBlocker != nullptr) {
+            dcBlocker->lastInput = lastInput;
+            dcBlocker->lastOutput = lastOutput;
+        }
+    }
+
+    template<bool Accumulate, typename Math, typename Source>
+    ShapeBlockFor<Source> getShapeBlock(int function) {     // jump table in WaveShaperFunction order
+        static constexpr ShapeBlockFor<Source> table[] = {
+            &shapeBlock<HardClip, Accumulate, Source>, &shapeBlock<SoftClip, Accumulate, Source>, &shapeBlock<Cracked<Math>, Accumulate, Source>,
+            &shapeBlock<GNOME, Accumulate, Source>, &shapeBlock<Warm, Accumulate, Source>, &shapeBlock<Quantize, Accumulate, Source>,
+            &shapeBlock<Fuzz<Math>, Accumulate, Source>, &shapeBlock<Hollowing<Math>, Accumulate, Source>, &shapeBlock<Sin<Math>, Accumulate, Source>,
+            &shapeBlock<Rash, Accumulate, Source>, &shapeBlock<Spiked<Math>, Accumulate, Source>, &shapeBlock<Titruff, Accumulate, Source>
+        };
+        return table[function];
+    }
+    template<bool Accumulate, typename Source = Constant>
+    ShapeBlockFor<Source> getShapeBlock(int function, bool useFastMath) {
+        return useFastMath ? getShapeBlock<Accumulate, FastMath, Source>(function) : getShapeBlock<Accumulate, ExactMath, Source>(function);
+    }
+
+    // single samples for places which are not per block, like drawing the curve
+    inline float shapeSample(int function, float x, float amount) {
+        switch (function) {     // WaveShaperFunction order
+            case 0: return HardClip(amount)(x);
+            case 1: return SoftClip(amount)(x);
+            case 2: return Cracked<ExactMath>(amount)(x);
+            case 3: return GNOME(amount)(x);
+            case 4: return Warm(amount)(x);
+            case 5: return Quantize(amount)(x);
+            case 6: return Fuzz<ExactMath>(amount)(x);
+            case 7: return Hollowing<ExactMath>(amount)(x);
+            case 8: return Sin<ExactMath>(amount)(x);
+            case 9: return Rash(amount)(x);
+            case 10: return Spiked<ExactMath>(amount)(x);
+            case 11: return Titruff(amount)(x);
+        }
+        return HardClip(amount)(x);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    BackgroundWorker.h
+    Created: 21 Oct 2026 2:37:18am
+    Author:  traxx
+
+    One background thread for the whole process (shared by all plugin instances via juce::SharedResourcePointer)
+    for work that follows parameter changes, like FIR design. It sleeps until a task is requested, so instances
+    whose features are off cost nothing
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class BackgroundWorker : private juce::Thread {
+public:
+    struct Task {
+        virtual ~Task() = default;
+        virtual void runTask() = 0;     // on the worker thread, never concurrently with add/remove of the same task
+
+    private:
+        friend class BackgroundWorker;
+        std::atomic<bool> isPending{ false };
+    };
+
+    BackgroundWorker() : juce::Thread("GnomeDistort background worker") { startThread(); }
+    ~BackgroundWorker() override { stopThread(1000); }
+
+    // both block while the task is running, so a task being prepared or destroyed is never run at the same time
+    void add(Task& task) {
+        const juce::ScopedLock lock(tasksLock);
+        tasks.addIfNotAlreadyThere(&task);
+    }
+    void remove(Task& task) {
+        const juce::ScopedLock lock(tasksLock);
+        tasks.removeFirstMatchingValue(&task);
+    }
+
+    // any thread, lock-free apart from waking the worker; requests arriving before the task runs are coalesced
+    void request(Task& task) {
+        task.isPending = true;
+        notify();
+    }
+
+private:
+    static constexpr int SettleMs = 30;     // requests come in bursts (automation, sweeps); at most one run per interval
+
+    void run() override {
+        while (!threadShouldExit()) {
+            wait(-1);
+            if (threadShouldExit()) return;
+            sleep(SettleMs);    // also lets the parameter change which triggered the request reach the APVTS values
+            const juce::ScopedLock lock(tasksLock);
+            for (auto* task : tasks) {
+                if (task->isPending.exchange(false)) task->runTask();
+            }
+        }
+    }
+
+    juce::CriticalSection tasksLock;
+    juce::Array<Task*> tasks;
+};
@@ -14,36 +14,66 @@
 
 #include <JuceHeader.h>
 #include "Fifo.h"
+#include "../DSP/FastMath.h"
 
 enum FFTOrder {
     order2048 = 11,
     order4096 = 12,
-    order8192 = 13
+    order8192 = 13,
+    order16384 = 14,    // the larger orders are for offline analysis (Tools/DistortionAnalyzer), not the editor
+    order32768 = 15,
+    order65536 = 16
+};
+
+// FFT engines and Blackman-Harris tables, one per order for the whole process (shared via juce::SharedResourcePointer).
+// Entries are reference counted: they live as long as any analyzer uses that order.
+struct FFTRegistry {
+    struct Resources {
+        explicit Resources(int order) : fft(order), window((size_t)1 << order) {
+            juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), window.size(), juce::dsp::WindowingFunction<float>::blackmanHarris, true);
+        }
+        juce::dsp::FFT fft;
+        std::vector<float> window;
+    };
+
+    std::shared_ptr<const Resources> acquire(FFTOrder order) {
+        const juce::ScopedLock lock(registryLock);
+        auto& entry = entries[order];
+        auto resources = entry.lock();
+        if (resources == nullptr) {
+            resources = std::make_shared<const Resources>(order);
+            entry = resources;
+        }
+        return resources;
+    }
+
+private:
+    juce::CriticalSection registryLock;
+    std::map<int, std::weak_ptr<const Resources>> entries;
 };
 
 template<typename BlockType>
 struct FFTDataGenerator {
     void produceFFTData(const juce::AudioBuffer<float>& audioData, const float negativeInfinity) {
         const auto fftSize = getFFTSize();
-        fftData.assign(fftData.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, fftData.begin());
-
-        window->multiplyWithWindowingTable(fftData.data(), fftSize);    // apply windowing function to data
-        forwardFFT->performFrequencyOnlyForwardTransform(fftData.data());   // render
-        int numBins = (int)fftSize / 2;
-        for (int i = 0; i < numBins; i++) {
-            fftData[i] /= (float)numBins;   // normalize
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);  // convert to dB
-        }
-        fftDataFifo.push(fftData);
+        // windowed straight into the preallocated buffer; the upper half is the FFT's workspace and needs no clearing
+        juce::FloatVectorOperations::multiply(fftData.data(), audioData.getReadPointer(0), resources->window.data(), fftSize);
+        resources->fft.performFrequencyOnlyForwardTransform(fftData.data());   // render
+
+        // normalize, convert to dB and clamp in one branch-free pass: 20 log10(x / numBins) = 20 log10(2) log2(x) - 20 log10(numBins)
+        const int numBins = fftSize / 2;
+        constexpr float DecibelsPerOctave = 6.0205999f;
+        const float normalization = -DecibelsPerOctave * (float)(order - 1);    // numBins is 2^(order - 1)
+        float* data = fftData.data();
+        for (int i = 0; i < numBins; i++) data[i] = std::max(negativeInfinity, (FastMath::log2(data[i]) * DecibelsPerOctave) + normalization);
+        fftDataFifo.push(fftData);  // fftData is now the slot's previous frame, same size
     }
 
     void changeOrder(FFTOrder newOrder) {
+        if (resources != nullptr && newOrder == order) return;
         order = newOrder;
         auto fftSize = getFFTSize();
-        forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        resources = registry->acquire(order);   // previous order is released, and freed if nobody else uses it
         fftData.clear();
         fftData.resize(fftSize * 2, 0);
         fftDataFifo.prepare(fftData.size());
@@ -51,13 +81,17 @@ struct FFTDataGenerator {
 
     int getFFTSize() const { return 1 << order; };
     int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
-    bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
+    // exchanged with the oldest frame; a frame of another size (e.g. from before an order change) is resized once first
+    bool getFFTData(BlockType& frame) {
+        if (frame.size() != fftData.size()) frame.resize(fftData.size(), 0);
+        return fftDataFifo.pull(frame);
+    }
 
 private:
     FFTOrder order;
     BlockType fftData;
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    juce::SharedResourcePointer<FFTRegistry> registry;
+    std::shared_ptr<const FFTRegistry::Resources> resources;
     Fifo<BlockType> fftDataFifo;
 };
 
@@ -71,7 +105,8 @@ struct AnalyzerPathGenerator {
         float width = fftBounds.getWidth();
         int numBins = (int)fftSize / 2;
 
-        PathType p;
+        PathType& p = path;     // reused: clearing keeps its storage, and pushing exchanges it for another reused one
+        p.clear();
         p.preallocateSpace(3 * (int)width);
 
         auto map = [bottom, top, negativeInfinity](float v) {
@@ -105,4 +140,5 @@ struct AnalyzerPathGenerator {
 
 private:
     Fifo<PathType> pathFifo;
+    PathType path;
 };
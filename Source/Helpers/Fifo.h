@@ -11,6 +11,7 @@
 #pragma once
 
 #include <array>
+#include <utility>
 
 enum Channel {
     Left,
@@ -33,10 +34,12 @@ struct Fifo {
         }
     }
 
-    bool push(const T& t) {
+    // push and pull exchange t with a slot instead of copying: the caller gets back the slot's previous contents, which
+    // prepare sized like all others. As long as the caller's object has that size too, nothing is copied or allocated.
+    bool push(T& t) {
         auto write = fifo.write(1);
         if (write.blockSize1 > 0) {
-            buffers[write.startIndex1] = t;
+            std::swap(buffers[write.startIndex1], t);
             return true;
         }
         return false;
@@ -45,7 +48,7 @@ struct Fifo {
     bool pull(T& t) {
         auto read = fifo.read(1);
         if (read.blockSize1 > 0) {
-            t = buffers[read.startIndex1];
+            std::swap(t, buffers[read.startIndex1]);
             return true;
         }
         return false;
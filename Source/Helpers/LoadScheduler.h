@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    LoadScheduler.h
+    Created: 20 Oct 2026 2:03:51pm
+    Author:  traxx
+
+    Process-wide (shared by all plugin instances via juce::SharedResourcePointer) schedule for the economy profile:
+    every instance gets a slot, and periodic heavy work only happens on the instance's turn, so with many instances
+    the work is spread over Period blocks / analyzer ticks instead of piling up in the same one
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct LoadScheduler {
+    static constexpr int Period = 4;
+
+    int acquireSlot() { return nextSlot.fetch_add(1) % Period; }
+
+    // Turns follow the scheduler's clock, not the caller's own count of calls: ticks of tickSeconds since the scheduler
+    // was created, the same for every instance. A slot's turn is every Period-th tick, so instances with the same tick
+    // length (block size and rate for the audio thread, timer rate for analyzers) are spread over Period ticks no matter
+    // how many calls each one skipped. A turn whose tick passed without a call (bypass, silence, a late callback) is
+    // taken on the next call. lastTurn is the caller's state, start it at NoTurn.
+    static constexpr juce::int64 NoTurn = std::numeric_limits<juce::int64>::min();
+    bool isTurn(int slot, double tickSeconds, juce::int64& lastTurn) const {
+        const auto tick = (juce::int64)((juce::Time::getMillisecondCounterHiRes() - epochMs) / (tickSeconds * 1000.0));
+        const auto scheduled = tick - ((tick + slot) % Period);     // the slot's latest turn up to now
+        if (scheduled <= lastTurn && tick >= lastTurn) return false;    // served already (a smaller tick: tickSeconds grew)
+        lastTurn = scheduled;
+        return true;
+    }
+
+private:
+    std::atomic<int> nextSlot{ 0 };
+    const double epochMs = juce::Time::getMillisecondCounterHiRes();
+};
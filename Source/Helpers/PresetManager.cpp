@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+    PresetManager.cpp
+    Created: 20 Oct 2026 9:31:44pm
+    Author:  traxx
+
+  ==============================================================================
+*/
+
+#include "PresetManager.h"
+#include "../DSP/Chain.h"
+
+static const juce::uint32 BankMagic = juce::ByteOrder::littleEndianInt("GDBK");
+static const juce::uint32 StateMagic = juce::ByteOrder::littleEndianInt("GDST");
+static constexpr int MaxNameLength = 255;   // names are stored with a one byte length
+
+static float readLittleEndianFloat(const void* bytes) {     // as written by OutputStream::writeFloat, no alignment needed
+    const juce::uint32 bits = juce::ByteOrder::littleEndianInt(bytes);
+    float value;
+    std::memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+static juce::CriticalSection& getUserBankProcessLock() {   // the InterProcessLock doesn't exclude instances within one process
+    static juce::CriticalSection lock;
+    return lock;
+}
+
+PresetManager::PresetManager(juce::AudioProcessor& processor) : processor(processor) {
+    const juce::ScopedLock processLock(getUserBankProcessLock());
+    const juce::InterProcessLock::ScopedLockType fileLock(userBankLock);
+    if (!loadUserBank()) {
+        presets.clear();
+        presets.push_back({ "Default", captureValues(true) });
+    }
+}
+
+juce::String PresetManager::getName(int index) const {
+    return juce::isPositiveAndBelow(index, getNumPresets()) ? presets[index].name : juce::String();
+}
+
+int PresetManager::indexOf(const juce::String& name) const {
+    for (int i = 0; i < getNumPresets(); i++) {
+        if (presets[i].name == name) return i;
+    }
+    return -1;
+}
+
+void PresetManager::apply(int index) {
+    if (!juce::isPositiveAndBelow(index, getNumPresets())) return;
+    currentIndex = index;
+    applyValues(presets[index].values.data(), (int)presets[index].values.size());
+    sendChangeMessage();
+}
+
+// presets are found again by name after re-reading, another instance may have moved them
+int PresetManager::storeCurrent(const juce::String& name) {
+    modifyUserBank([this, &name]() {
+        presets.push_back({ name, captureValues(true) });
+        currentIndex = getNumPresets() - 1;
+    });
+    return currentIndex;
+}
+
+void PresetManager::overwrite(int index) {
+    const auto name = getName(index);
+    if (name.isEmpty()) return;
+    modifyUserBank([this, &name]() {
+        const int found = indexOf(name);
+        if (found < 0) presets.push_back({ name, captureValues(true) });    // deleted meanwhile
+        else presets[found].values = captureValues(true);
+        currentIndex = found < 0 ? getNumPresets() - 1 : found;
+    });
+}
+
+void PresetManager::rename(int index, const juce::String& newName) {
+    const auto name = getName(index);
+    if (name.isEmpty() || newName.isEmpty()) return;
+    modifyUserBank([this, &name, &newName]() {
+        const int found = indexOf(name);
+        if (found >= 0) presets[found].name = newName;
+    });
+}
+
+void PresetManager::refresh() {
+    const juce::ScopedLock processLock(getUserBankProcessLock());
+    const juce::InterProcessLock::ScopedLockType fileLock(userBankLock);
+    loadUserBank();
+}
+
+bool PresetManager::isPresetParameter(int parameterIndex) {
+    switch (parameterIndex) {
+        case PosDisplayON: case PosDisplayHQ: case PosBypass: case PosPrecision: case PosEconomy:
+        case PosAnalyzerPreTap: case PosAnalyzerPostTap: case PosDisplayMode:
+            return false;
+        default:
+            return true;
+    }
+}
+
+std::vector<float> PresetManager::captureValues(bool soundOnly) const {
+    const auto& parameters = processor.getParameters();
+    std::vector<float> values((size_t)parameters.size());
+    for (int i = 0; i < parameters.size(); i++) {
+        values[i] = soundOnly && !isPresetParameter(i) ? parameters[i]->getDefaultValue() : parameters[i]->getValue();
+    }
+    return values;
+}
+
+void PresetManager::applyValues(const float* values, int numValues) {
+    const auto& parameters = processor.getParameters();
+    for (int i = 0; i < parameters.size(); i++) {
+        if (!isPresetParameter(i)) continue;
+        const float value = i < numValues ? juce::jlimit(0.f, 1.f, values[i]) : parameters[i]->getDefaultValue();
+        if (value != parameters[i]->getValue()) parameters[i]->setValueNotifyingHost(value);
+    }
+}
+
+//==============================================================================
+// bank: magic, version, numParameters, numPresets, then per preset: name length (1 byte), UTF-8 name, values
+void PresetManager::writeBank(juce::OutputStream& stream) const {
+    const auto& parameters = processor.getParameters();
+    const int numParameters = parameters.size();
+    stream.writeInt((int)BankMagic);
+    stream.writeInt(Version);
+    stream.writeInt(numParameters);
+    stream.writeInt(getNumPresets());
+    for (const auto& preset : presets) {
+        auto name = preset.name;
+        while (name.getNumBytesAsUTF8() > (size_t)MaxNameLength) name = name.dropLastCharacters(1);  // whole characters only
+        const int nameLength = (int)name.getNumBytesAsUTF8();
+        stream.writeByte((char)nameLength);
+        stream.write(name.toRawUTF8(), (size_t)nameLength);
+        for (int i = 0; i < numParameters; i++) {
+            stream.writeFloat(i < (int)preset.values.size() ? preset.values[i] : parameters[i]->getDefaultValue());
+        }
+    }
+}
+
+bool PresetManager::readBank(juce::InputStream& stream) {
+    if ((juce::uint32)stream.readInt() != BankMagic) return false;
+    if (stream.readInt() > Version) return false;
+    const int numParameters = stream.readInt();
+    const int numPresets = stream.readInt();
+    if (numParameters <= 0 || numPresets <= 0) return false;
+
+    std::vector<Preset> loaded((size_t)numPresets);
+    char name[MaxNameLength];
+    for (auto& preset : loaded) {
+        const int nameLength = (juce::uint8)stream.readByte();
+        if (stream.read(name, nameLength) != nameLength) return false;
+        preset.name = juce::String::fromUTF8(name, nameLength);
+        preset.values.resize((size_t)numParameters);
+        if (stream.read(preset.values.data(), numParameters * (int)sizeof(float)) != numParameters * (int)sizeof(float)) return false;
+        for (auto& value : preset.values) value = readLittleEndianFloat(&value);    // one bulk read, a no-op on little endian
+    }
+    presets = std::move(loaded);
+    currentIndex = juce::jmin(currentIndex, getNumPresets() - 1);
+    return true;
+}
+
+bool PresetManager::loadUserBank() {
+    juce::MemoryBlock data;
+    if (!getUserBankFile().loadFileAsData(data)) return false;
+    juce::MemoryInputStream stream(data, false);
+    return readBank(stream);
+}
+
+void PresetManager::modifyUserBank(const std::function<void()>& modification) {
+    const juce::ScopedLock processLock(getUserBankProcessLock());
+    const juce::InterProcessLock::ScopedLockType fileLock(userBankLock);
+    loadUserBank();     // keeps the bank in memory if there is no file yet
+    modification();
+    sendChangeMessage();
+    const auto file = getUserBankFile();
+    if (!file.getParentDirectory().createDirectory()) return;
+    juce::MemoryOutputStream stream;
+    writeBank(stream);
+    file.replaceWithData(stream.getData(), stream.getDataSize());   // through a temporary file, readers never see half of it
+}
+
+juce::File PresetManager::getUserBankFile() {
+#if GNOMEDISTORT_ISOLATED_PRESETS
+    static const juce::TemporaryFile isolatedBank(".gdbank");     // test builds: an empty bank of their own, removed on exit
+    return isolatedBank.getFile();
+#else
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("GnomeDistort").getChildFile("Presets.gdbank");
+#endif
+}
+
+//==============================================================================
+// state: magic, version, current program, numParameters, values
+void PresetManager::writeState(juce::MemoryBlock& destData) const {
+    juce::MemoryOutputStream stream(destData, false);
+    const auto values = captureValues(false);
+    stream.writeInt((int)StateMagic);
+    stream.writeInt(Version);
+    stream.writeInt(currentIndex);
+    stream.writeInt((int)values.size());
+    for (float value : values) stream.writeFloat(value);
+}
+
+bool PresetManager::restoreState(const void* data, int sizeInBytes) {
+    constexpr int HeaderSize = 4 * (int)sizeof(juce::int32);
+    if (sizeInBytes < HeaderSize) return false;
+    const auto* bytes = static_cast<const char*>(data);
+    if (juce::ByteOrder::littleEndianInt(bytes) != StateMagic) return false;
+    if ((int)juce::ByteOrder::littleEndianInt(bytes + 4) > Version) return false;
+    const int program = (int)juce::ByteOrder::littleEndianInt(bytes + 8);
+    const int numValues = std::min((int)juce::ByteOrder::littleEndianInt(bytes + 12), (sizeInBytes - HeaderSize) / (int)sizeof(float));
+
+    // values are read in place, parameters the state doesn't have go back to their default
+    const auto& parameters = processor.getParameters();
+    for (int i = 0; i < parameters.size(); i++) {
+        const float value = i < numValues ? juce::jlimit(0.f, 1.f, readLittleEndianFloat(bytes + HeaderSize + (i * sizeof(float))))
+                                          : parameters[i]->getDefaultValue();
+        if (value != parameters[i]->getValue()) parameters[i]->setValueNotifyingHost(value);
+    }
+    if (juce::isPositiveAndBelow(program, getNumPresets())) currentIndex = program;
+    sendChangeMessage();
+    return true;
+}
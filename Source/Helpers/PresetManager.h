@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    PresetManager.h
+    Created: 20 Oct 2026 9:31:27pm
+    Author:  traxx
+
+    Preset bank and plugin state in a compact binary format: a header (magic, version, parameter count) followed by
+    the normalised parameter values in TreeParameter order. Parameters are only ever appended, so older data loads
+    into a newer layout with defaults for the parameters it doesn't know.
+    Presets only hold the sound; the user bank file is shared by all instances and re-read under a lock before every
+    change, so changes from other instances are merged instead of overwritten.
+    A change message goes out whenever the current program or this instance's bank changes, host program changes included
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class PresetManager : public juce::ChangeBroadcaster {
+public:
+    static constexpr int Version = 1;
+
+    // loads the user bank, or starts one with the default settings
+    explicit PresetManager(juce::AudioProcessor& processor);
+
+    int getNumPresets() const { return (int)presets.size(); }
+    int getCurrentIndex() const { return currentIndex; }
+    juce::String getName(int index) const;
+
+    void apply(int index);                                  // sets the sound parameters (notifying the host)
+    // changes of the user bank, each written back to the file right away
+    int storeCurrent(const juce::String& name);             // appends the current sound, returns the index
+    void overwrite(int index);
+    void rename(int index, const juce::String& newName);
+    void refresh();                                         // picks up changes other instances made to the user bank; no change message
+
+    // false for bypass, display, analyzer and CPU settings, which presets neither store nor change
+    static bool isPresetParameter(int parameterIndex);
+    static juce::File getUserBankFile();                    // a temporary one in builds with GNOMEDISTORT_ISOLATED_PRESETS
+
+    // plugin state: current program and parameter values; restoring reads straight from the data and doesn't allocate
+    void writeState(juce::MemoryBlock& destData) const;
+    bool restoreState(const void* data, int sizeInBytes);   // false if data is not in this format
+
+private:
+    struct Preset {
+        juce::String name;
+        std::vector<float> values;
+    };
+
+    std::vector<float> captureValues(bool soundOnly) const;    // soundOnly: other parameters hold their default
+    void applyValues(const float* values, int numValues);   // parameters beyond numValues are reset to their default
+
+    void writeBank(juce::OutputStream& stream) const;
+    bool readBank(juce::InputStream& stream);               // replaces the bank; false leaves it untouched
+    bool loadUserBank();
+    // re-reads the bank, applies modification to it and writes it back, all under the process and file locks
+    void modifyUserBank(const std::function<void()>& modification);
+    int indexOf(const juce::String& name) const;            // -1 if there is no preset of that name
+
+    juce::AudioProcessor& processor;
+    std::vector<Preset> presets;
+    int currentIndex = 0;
+    juce::InterProcessLock userBankLock{ "GnomeDistortPresets" };
+};
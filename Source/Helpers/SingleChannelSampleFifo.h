@@ -20,12 +20,26 @@ struct SingleChannelSampleFifo {
     }
 
     void update(const BlockType& buffer) {
-        jassert(prepared.get());
         jassert(buffer.getNumChannels() > channelToUse);
-        auto* channelPtr = buffer.getReadPointer(channelToUse);
+        update(buffer.getReadPointer(channelToUse), buffer.getNumSamples());
+    }
 
-        for (int i = 0; i < buffer.getNumSamples(); i++) {
-            pushNextSample(channelPtr[i]);
+    // copies straight into the buffer being filled, which is pushed whenever it is full; gain is applied on the way
+    void update(const float* samples, int numSamples, float gain = 1.f) {
+        jassert(prepared.get());
+        while (numSamples > 0) {
+            if (fifoIndex == bufferToFill.getNumSamples()) {
+                auto ok = audioBufferFifo.push(bufferToFill);
+                juce::ignoreUnused(ok);
+                fifoIndex = 0;
+            }
+            const int length = std::min(numSamples, bufferToFill.getNumSamples() - fifoIndex);
+            float* destination = bufferToFill.getWritePointer(0, fifoIndex);
+            if (gain == 1.f) juce::FloatVectorOperations::copy(destination, samples, length);
+            else juce::FloatVectorOperations::copyWithMultiply(destination, samples, gain, length);
+            fifoIndex += length;
+            samples += length;
+            numSamples -= length;
         }
     }
 
@@ -41,8 +55,12 @@ struct SingleChannelSampleFifo {
 
     int getNumCompletedBuffersAvailable() const { return audioBufferFifo.getNumAvailableForReading(); }
     bool isPrepared() const { return prepared.get(); }
-    int getSize() const { return size.get() }
-    bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+    int getSize() const { return size.get(); }
+    // buf is exchanged with the oldest completed buffer; it is sized like the others first, so it can go into the fifo
+    bool getAudioBuffer(BlockType& buf) {
+        if (buf.getNumChannels() != 1 || buf.getNumSamples() != getSize()) buf.setSize(1, getSize(), false, true, true);
+        return audioBufferFifo.pull(buf);
+    }
 
 private:
     Channel channelToUse;
@@ -51,14 +69,4 @@ private:
     BlockType bufferToFill;
     juce::Atomic<bool> prepared = false;
     juce::Atomic<int> size = 0;
-
-    void pushNextSample(float sample) {
-        if (fifoIndex == bufferToFill.getNumSamples()) {
-            auto ok = audioBufferFifo.push(bufferToFill);
-            juce::ignoreUnused(ok);
-            fifoIndex = 0;
-        }
-        bufferToFill.setSample(0, fifoIndex, sample);
-        ++fifoIndex;
-    }
 };
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    TransferScope.h
+    Created: 21 Oct 2026 2:26:41am
+    Author:  traxx
+
+    Decimated (input, output) pairs of the waveshaper for the transfer graph, from the audio thread to the UI
+    through a fixed-size lock-free ring. Points which don't fit are dropped, so the audio side cost stays bounded
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+struct TransferScope {
+    struct Point {
+        float input, output;    // on the curve's scale: after PreGain (with envelope drive) and Bias, before band gain and PostGain
+    };
+    static constexpr int Capacity = 4096;
+    static constexpr int Decimation = 16;   // every 16th sample, 3000 points per second at 48 kHz
+
+    void prepare(int maximumBlockSize) {
+        pending.assign((size_t)(maximumBlockSize / Decimation) + 1, 0.f);
+        numPending = 0;
+        nextSample = 0;
+    }
+
+    // fed only while a graph is showing it
+    void setActive(bool shouldBeActive) { active = shouldBeActive; }
+    bool isActive() const { return active.load(); }
+
+    // audio thread: the decimated samples of a block before the waveshaper, then the same block after it;
+    // preGain is indexed per sample (one value or one per sample, like the amounts of the kernel loops)
+    template<typename Gain>
+    void captureInput(const float* input, int numSamples, Gain preGain, float bias) {
+        numPending = 0;
+        for (int i = nextSample; i < numSamples && numPending < (int)pending.size(); i += Decimation) pending[numPending++] = (input[i] * preGain[i]) + bias;
+    }
+    void pushOutput(const float* output, int numSamples, float gain) {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numPending, start1, size1, start2, size2);
+        for (int i = 0; i < size1; i++) points[start1 + i] = { pending[i], output[nextSample + (i * Decimation)] * gain };
+        for (int i = 0; i < size2; i++) points[start2 + i] = { pending[size1 + i], output[nextSample + ((size1 + i) * Decimation)] * gain };
+        fifo.finishedWrite(size1 + size2);
+        nextSample = std::max(0, nextSample + (numPending * Decimation) - numSamples);     // decimation continues across blocks
+    }
+
+    // UI thread: returns the number of points copied to destination
+    int pull(Point* destination, int maxPoints) {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxPoints, start1, size1, start2, size2);
+        std::copy(points.begin() + start1, points.begin() + start1 + size1, destination);
+        std::copy(points.begin() + start2, points.begin() + start2 + size2, destination + size1);
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+private:
+    std::array<Point, Capacity> points;
+    juce::AbstractFifo fifo{ Capacity };
+    std::vector<float> pending;     // captured inputs of the current block
+    int numPending = 0, nextSample = 0;
+    std::atomic<bool> active{ false };
+};
@@ -25,6 +25,8 @@ GnomeDistortAudioProcessorEditor::GnomeDistortAudioProcessorEditor(GnomeDistortA
     DisplayHQSwitch(*audioProcessor.apvts.getParameter("DisplayHQ"), false, "HQ", "LQ", juce::Colours::white, COLOR_BG_VERYDARK),
     LinkGithubButton("GITHUB", juce::Colours::lightgrey, false, false),
     LinkDonateButton("DONATE", juce::Colours::lightgrey, false, false),
+    PresetNewButton("NEW", juce::Colours::lightgrey, false, false),
+    PresetSaveButton("SAVE", juce::Colours::lightgrey, false, false),
 
     displayComp(audioProcessor),    // init display
 
@@ -55,6 +57,7 @@ GnomeDistortAudioProcessorEditor::GnomeDistortAudioProcessorEditor(GnomeDistortA
     LoCutSlopeSelect.setLookAndFeel(&ComboBoxLNF);
     HiCutSlopeSelect.setLookAndFeel(&ComboBoxLNF);
     WaveshapeSelect.setLookAndFeel(&ComboBoxLNF);
+    PresetSelect.setLookAndFeel(&ComboBoxLNF);
     ComboBoxLNF.setColour(juce::ComboBox::ColourIds::backgroundColourId, COLOR_BG_DARK);
     ComboBoxLNF.setColour(juce::ComboBox::ColourIds::textColourId, juce::Colours::white);
     ComboBoxLNF.setColour(juce::ComboBox::ColourIds::outlineColourId, COLOR_BG_VERYDARK);
@@ -92,6 +95,39 @@ GnomeDistortAudioProcessorEditor::GnomeDistortAudioProcessorEditor(GnomeDistortA
         juce::URL("https://ko-fi.com/crowbait").launchInDefaultBrowser();
     };
 
+    // presets: selecting goes through the host program, so it crossfades like a program change from the host
+    PresetSelect.setEditableText(true);
+    updatePresetSelect();
+    audioProcessor.presets.addChangeListener(this);
+    PresetSelect.onPopup = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->audioProcessor.presets.refresh();
+            comp->updatePresetSelect();
+        }
+    };
+    PresetSelect.onChange = [safePtr]() {
+        auto* comp = safePtr.getComponent();
+        if (comp == nullptr) return;
+        auto& presets = comp->audioProcessor.presets;
+        const int index = comp->PresetSelect.getSelectedId() - 1;
+        if (index < 0) presets.rename(presets.getCurrentIndex(), comp->PresetSelect.getText().trim());     // typed name
+        else if (index != presets.getCurrentIndex()) comp->audioProcessor.setCurrentProgram(index);
+        comp->presetsChanged();
+    };
+    PresetNewButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            auto& presets = comp->audioProcessor.presets;
+            presets.storeCurrent("Preset " + juce::String(presets.getNumPresets() + 1));
+            comp->presetsChanged();
+        }
+    };
+    PresetSaveButton.onClick = [safePtr]() {
+        if (auto* comp = safePtr.getComponent()) {
+            comp->audioProcessor.presets.overwrite(comp->audioProcessor.presets.getCurrentIndex());
+            comp->presetsChanged();
+        }
+    };
+
     setSize(420, 600);
     checkForUpdates();
 }
@@ -104,7 +140,21 @@ void GnomeDistortAudioProcessorEditor::paint(juce::Graphics& g) {
     g.drawImageAt(background, 0, 0);
 }
 
-GnomeDistortAudioProcessorEditor::~GnomeDistortAudioProcessorEditor() {}
+GnomeDistortAudioProcessorEditor::~GnomeDistortAudioProcessorEditor() {
+    audioProcessor.presets.removeChangeListener(this);
+}
+
+void GnomeDistortAudioProcessorEditor::updatePresetSelect() {
+    const auto& presets = audioProcessor.presets;
+    PresetSelect.clear(juce::dontSendNotification);
+    for (int i = 0; i < presets.getNumPresets(); i++) PresetSelect.addItem(presets.getName(i), i + 1);
+    PresetSelect.setSelectedId(presets.getCurrentIndex() + 1, juce::dontSendNotification);
+}
+
+void GnomeDistortAudioProcessorEditor::presetsChanged() {
+    updatePresetSelect();
+    audioProcessor.updateHostDisplay(juce::AudioProcessorListener::ChangeDetails().withProgramChanged(true));
+}
 
 void GnomeDistortAudioProcessorEditor::paintBackground() {
     using namespace juce;
@@ -323,6 +373,11 @@ void GnomeDistortAudioProcessorEditor::resized() {
     DisplayHQSwitch.setBounds(switchesArea.removeFromLeft(padding * 2));
     LinkDonateButton.setBounds(switchesArea.removeFromRight(padding * 5));
     LinkGithubButton.setBounds(switchesArea.removeFromRight(padding * 5));
+    switchesArea.removeFromLeft(padding);
+    switchesArea.removeFromRight(padding / 2);
+    PresetSaveButton.setBounds(switchesArea.removeFromRight(padding * 4));
+    PresetNewButton.setBounds(switchesArea.removeFromRight(padding * 4));
+    PresetSelect.setBounds(switchesArea.reduced(0, padding / 4));
 
     bounds.removeFromLeft(padding);
     bounds.removeFromRight(padding);
@@ -422,6 +477,10 @@ std::vector<juce::Component*> GnomeDistortAudioProcessorEditor::getComponents()
         &DisplayONSwitch,
         &DisplayHQSwitch,
         &LinkGithubButton,
-        &LinkDonateButton
+        &LinkDonateButton,
+
+        &PresetSelect,
+        &PresetNewButton,
+        &PresetSaveButton
     };
 }
@@ -35,10 +35,22 @@ enum compIndex {
     DisplayONSwitch,
     DisplayHQSwitch,
     LinkGithubButton,
-    LinkDonateButton
+    LinkDonateButton,
+
+    PresetSelect,
+    PresetNewButton,
+    PresetSaveButton
+};
+
+struct PresetSelectBox : juce::ComboBox {
+    std::function<void()> onPopup;  // before the list opens, to pick up presets stored by other instances
+    void showPopup() override {
+        if (onPopup) onPopup();
+        juce::ComboBox::showPopup();
+    }
 };
 
-class GnomeDistortAudioProcessorEditor : public juce::AudioProcessorEditor {
+class GnomeDistortAudioProcessorEditor : public juce::AudioProcessorEditor, private juce::ChangeListener {
 public:
     GnomeDistortAudioProcessorEditor(GnomeDistortAudioProcessor&);
     ~GnomeDistortAudioProcessorEditor() override;
@@ -58,6 +70,11 @@ private:
     juce::ComboBox LoCutSlopeSelect, HiCutSlopeSelect, WaveshapeSelect;
     SimpleTextSwitch DisplayONSwitch, DisplayHQSwitch;
     SimpleTextButton LinkGithubButton, LinkDonateButton;
+    PresetSelectBox PresetSelect;       // editable: typing a name renames the current preset
+    SimpleTextButton PresetNewButton, PresetSaveButton;
+    void updatePresetSelect();
+    void presetsChanged();
+    void changeListenerCallback(juce::ChangeBroadcaster*) override { updatePresetSelect(); }    // host program changes, restored state
 
     using APVTS = juce::AudioProcessorValueTreeState;
     APVTS::SliderAttachment LoCutFreqSliderAttachment, PeakFreqSliderAttachment, PeakGainSliderAttachment, PeakQSliderAttachment,
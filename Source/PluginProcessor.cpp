@@ -16,14 +16,23 @@ GnomeDistortAudioProcessor::GnomeDistortAudioProcessor()
 #if ! JucePlugin_IsMidiEffect
 #if ! JucePlugin_IsSynth
                      .withInput("Input", juce::AudioChannelSet::stereo(), true)
+                     .withInput("Sidechain", juce::AudioChannelSet::stereo(), false)
 #endif
                      .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
     )
 #endif
-{}
+{
+    for (auto param : getParameters()) {    // register as listener to know when automation has to be ramped
+        param->addListener(this);
+    }
+}
 
-GnomeDistortAudioProcessor::~GnomeDistortAudioProcessor() {}
+GnomeDistortAudioProcessor::~GnomeDistortAudioProcessor() {
+    for (auto param : getParameters()) {
+        param->removeListener(this);
+    }
+}
 
 //==============================================================================
 const juce::String GnomeDistortAudioProcessor::getName() const {
@@ -55,39 +64,46 @@ bool GnomeDistortAudioProcessor::isMidiEffect() const {
 }
 
 double GnomeDistortAudioProcessor::getTailLengthSeconds() const {
-    return 0.0;
+    const double sampleRate = getSampleRate();
+    const double latencySeconds = sampleRate > 0 ? 2 * latencySamples.get() / sampleRate : 0.0;    // delay plus FIR post-ringing
+    return getFilterRingOutSeconds(getChainSettings(apvts)) + latencySeconds;
 }
 
 int GnomeDistortAudioProcessor::getNumPrograms() {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-    // so this should be at least 1, even if you're not really implementing programs.
+    return presets.getNumPresets();     // never 0, the bank always holds at least the default preset
 }
 
 int GnomeDistortAudioProcessor::getCurrentProgram() {
-    return 0;
+    return presets.getCurrentIndex();
 }
 
-void GnomeDistortAudioProcessor::setCurrentProgram(int index) {}
+void GnomeDistortAudioProcessor::setCurrentProgram(int index) {
+    programChanged.set(true);   // before the values, so the audio thread fades out with the settings it is running with
+    presets.apply(index);
+}
 
 const juce::String GnomeDistortAudioProcessor::getProgramName(int index) {
-    return {};
+    return presets.getName(index);
+}
+
+void GnomeDistortAudioProcessor::changeProgramName(int index, const juce::String& newName) {
+    presets.rename(index, newName);
+}
+
+juce::AudioProcessorParameter* GnomeDistortAudioProcessor::getBypassParameter() const {
+    return apvts.getParameter("Bypass");
 }
 
-void GnomeDistortAudioProcessor::changeProgramName(int index, const juce::String& newName) {}
+void GnomeDistortAudioProcessor::parameterValueChanged(int parameterIndex, float newValue) {
+    if (isChainSettingsParameter(parameterIndex)) parametersChanged.set(true);     // display switches don't ramp the chain
+    if (LinearPhaseFilter::dependsOn(parameterIndex)) linearPhase.requestUpdate();
+    if (AutoGain::dependsOn(parameterIndex)) autoGain.requestUpdate();
+}
 
 //==============================================================================
 //==============================================================================
 //==============================================================================
 
-// HELPERS
-Coefficients generatePeakFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate, chainSettings.PeakFreq, chainSettings.PeakQ,
-        juce::Decibels::decibelsToGain(chainSettings.PeakGain)); // convert decibels to gain value
-}
-void updateCoefficients(Coefficients& old, const Coefficients& replace) {
-    *old = *replace;
-}
 juce::StringArray GnomeDistortAudioProcessor::getSlopeOptions() {
     juce::StringArray result;
     for (int i = 0; i < 4; i++) {
@@ -99,146 +115,123 @@ juce::StringArray GnomeDistortAudioProcessor::getSlopeOptions() {
     return result;
 }
 
-
-
-std::function<float(float)> getWaveshaperFunction(WaveShaperFunction& func, float& amount) {
-    switch (func) {
-        case HardClip:
-            return [amount](float x) { return juce::jlimit(0.f - (1.f - amount), 1.f - amount, x) + (x < 0 ? -amount : amount); };
-            break;
-        case SoftClip:  // x * sqrt(1+a²) - scaling factor 5
-            return [amount](float x) { return juce::jlimit(-1.f, 1.f, x * sqrt(1 + ((amount * 5) * (amount * 5)))); };
-            break;
-        case Cracked:   // x³ * cos(x*a)³ - scaling factor 9.4
-            return [amount](float x) { return juce::jlimit(-1.f, 1.f, (float)(pow(x, 3) * pow((cos(x * amount * 9.4f)), 3))); };
-            break;
-        case GNOME:   // x - (a/x)
-            return [amount](float x) { return juce::jlimit(-1.f, 1.f, x == 0 ? 0 : x - (amount / x)); };
-            break;
-        case Warm:      // x < 0: x*a   --  x > 0: x*(1+a)
-            return [amount](float x) {
-                if (x <= 0) return juce::jlimit(-1.f, 1.f, x * (1.f - amount));
-                return juce::jlimit(-1.f, 1.f, x * (1.f + amount));
-            }; break;
-        case Quantize: {
-            int numSteps = 1 + std::floor((1 / (amount + 0.01f)) * 2);
-            return [numSteps](float x) {
-                int quant = (std::min(numSteps, (int)(std::abs(x * numSteps))));
-                return juce::jlimit(-1.f, 1.f, (float)(x < 0 ? (0 - ((1.f / numSteps) * quant)) : ((1.f / numSteps) * quant)));
-            };
-        } break;
-        case Fuzz:      // x + (a * sin(10a * x))
-            return [amount](float x) { return juce::jlimit(-1.f, 1.f, x + (amount * sin(10 * amount * x))); };
-            break;
-        case Hollowing: // x * (3a * sin(x)) - x - a
-            return [amount](float x) { return juce::jlimit(-1.f, 1.f, x * (3 * amount * sin(x)) - x - amount); };
-            break;
-        case Sin:
-            return [amount](float x) { return juce::jlimit(-1.f, 1.f, 2 * amount * sin(x * 100 * amount) + ((1 - amount) * x)); };
-            break;
-        case Rash: {      //  -1           -0.8          -0.6          -0.4          -0.2           0            0.2           0.4           0.6           0.8           1
-            const float noise[] = { 2.22f, 3.21f, 1.38f, 0.21f, 3.66f, 1.51f, 3.41f, 2.14f, 2.09f, 0.31f, 1.15f, 3.15f, 2.58f, 0.91f, 1.18f, 4.29f, 3.24f, 0.11f, 0.05f, 2.11f, 1.77f };
-            return [amount, noise](float x) {
-                const float factor =
-                    (x < -0.9f) ? noise[0] : (x < -0.8f) ? noise[1] :
-                    (x < -0.7f) ? noise[2] : (x < -0.6f) ? noise[3] :
-                    (x < -0.5f) ? noise[4] : (x < -0.4f) ? noise[5] :
-                    (x < -0.3f) ? noise[6] : (x < -0.2f) ? noise[7] :
-                    (x < -0.1f) ? noise[8] : (x < 0.f) ? noise[9] :
-                    (x < 0.1f) ? noise[10] : (x < 0.2f) ? noise[11] :
-                    (x < 0.3f) ? noise[12] : (x < 0.4f) ? noise[13] :
-                    (x < 0.5f) ? noise[14] : (x < 0.6f) ? noise[15] :
-                    (x < 0.7f) ? noise[16] : (x < 0.8f) ? noise[17] :
-                    (x < 0.9f) ? noise[18] : (x < 1.f) ? noise[19] : noise[20];
-                return juce::jlimit(-1.f, 1.f, (factor * x * amount) + (x * (1.f - amount)));
-            };
-        } break;
-        case Spiked: {
-            const float pi3p16 = 3 * 3.14159f / 16;
-            return [amount, pi3p16](float x) {
-                float ret;
-                if (x < -pi3p16) return juce::jlimit(-1.f, 1.f, amount + (x * (1.f - amount)));
-                if (x < 0) return juce::jlimit(-1.f, 1.f, (sin(8 * x) * amount) + (x * (1.f - amount)));
-                if (x < 0.25f) return juce::jlimit(-1.f, 1.f, ((sin(10 * x) + 0.25f) * amount) + (x * (1.f - amount)));
-                if (x < 0.5f) return juce::jlimit(-1.f, 1.f, ((sin(10 * x + 1) + 0.25f) * amount) + (x * (1.f - amount)));
-                if (x < 0.75f) return juce::jlimit(-1.f, 1.f, ((sin(10 * x + 2) + 0.25f) * amount) + (x * (1.f - amount)));
-                return juce::jlimit(-1.f, 1.f, x * (1.f - amount) + amount);
-            };
-        } break;
-        case Titruff: {
-            return [amount](float x) {
-                if (x > -0.162f && x < 0.162f) return ((-10.f * x * x + 1) * amount) + (x * (1.f - amount));
-                return juce::jlimit(-1.f, 1.f, ((-0.5f * x * x + 0.75f) * amount) + (x * (1.f - amount)));
-            }; break;
+void GnomeDistortAudioProcessor::updateSettings(const ChainSettings& chainSettings, bool forceUpdate) {
+    const double sampleRate = getSampleRate();
+    const ChainSettings& old = appliedSettings;     // only stages whose parameters changed are touched
+
+    // filter mode; in linear phase mode the FIR does all the filtering and the IIR stages are skipped
+    const bool phaseModeChanged = chainSettings.LinearPhase != old.LinearPhase;
+    if (forceUpdate || phaseModeChanged) {
+        for (auto* chain : { &leftChain, &rightChain }) {
+            chain->setBypassed<ChainPositions::LoCut>(chainSettings.LinearPhase);
+            chain->setBypassed<ChainPositions::Peak>(chainSettings.LinearPhase);
+            chain->setBypassed<ChainPositions::HiCut>(chainSettings.LinearPhase);
         }
     }
-}
+    if (phaseModeChanged) {     // IIR filters taking over start from silence
+        leftChain.reset();
+        rightChain.reset();
+    }
 
+    // LoCut filter coefficients
+    if (forceUpdate || chainSettings.LoCutFreq != old.LoCutFreq || chainSettings.LoCutSlope != old.LoCutSlope) {
+        updateLoCutFilter(leftChain.get<ChainPositions::LoCut>(), chainSettings, sampleRate, cutTables.get());
+        updateLoCutFilter(rightChain.get<ChainPositions::LoCut>(), chainSettings, sampleRate, cutTables.get());
+    }
 
-void updateSettings(ChainSettings& chainSettings, double sampleRate, MonoChain& leftChain, MonoChain& rightChain) {
-    // link LoCut filter coefficients
-    auto LoCutCoefficients = generateLoCutFilter(chainSettings, sampleRate);
-    auto& leftLoCut = leftChain.get<ChainPositions::LoCut>();
-    auto& rightLoCut = rightChain.get<ChainPositions::LoCut>();
-    updateCutFilter(leftLoCut, LoCutCoefficients, static_cast<FilterSlope>(chainSettings.LoCutSlope));
-    updateCutFilter(rightLoCut, LoCutCoefficients, static_cast<FilterSlope>(chainSettings.LoCutSlope));
+    // peak filter coefficients; looked up in the table for the current gain and Q, designed directly while a table for a
+    // new gain or Q is built in the background
+    if (forceUpdate || chainSettings.PeakFreq != old.PeakFreq || chainSettings.PeakGain != old.PeakGain || chainSettings.PeakQ != old.PeakQ) {
+        BiquadCoefficients coefficients;
+        if (!forceUpdate && peakTable.lookup(chainSettings.PeakGain, chainSettings.PeakQ, chainSettings.PeakFreq, coefficients)) {
+            *leftChain.get<ChainPositions::Peak>().coefficients = coefficients;
+            *rightChain.get<ChainPositions::Peak>().coefficients = coefficients;
+        } else {
+            updatePeakFilter(leftChain.get<ChainPositions::Peak>(), chainSettings, sampleRate);
+            updatePeakFilter(rightChain.get<ChainPositions::Peak>(), chainSettings, sampleRate);
+        }
+    }
 
-    // link peak filter coefficient
-    auto peakCoefficients = generatePeakFilter(chainSettings, sampleRate);
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    // HiCut filter coefficients
+    if (forceUpdate || chainSettings.HiCutFreq != old.HiCutFreq || chainSettings.HiCutSlope != old.HiCutSlope) {
+        updateHiCutFilter(leftChain.get<ChainPositions::HiCut>(), chainSettings, sampleRate, cutTables.get());
+        updateHiCutFilter(rightChain.get<ChainPositions::HiCut>(), chainSettings, sampleRate, cutTables.get());
+    }
 
-    // link HiCut filter coefficients
-    auto HiCutCoefficients = generateHiCutFilter(chainSettings, sampleRate);
-    auto& leftHiCut = leftChain.get<ChainPositions::HiCut>();
-    auto& rightHiCut = rightChain.get<ChainPositions::HiCut>();
-    updateCutFilter(leftHiCut, HiCutCoefficients, static_cast<FilterSlope>(chainSettings.HiCutSlope));
-    updateCutFilter(rightHiCut, HiCutCoefficients, static_cast<FilterSlope>(chainSettings.HiCutSlope));
+    // distortion
+    if (forceUpdate || chainSettings.PreGain != old.PreGain) distortion.setPreGain(chainSettings.PreGain);
+    if (forceUpdate || chainSettings.Bias != old.Bias) distortion.setBias(chainSettings.Bias);
+    if (forceUpdate || chainSettings.PostGain != old.PostGain) distortion.setPostGain(chainSettings.PostGain);
+    if (forceUpdate || chainSettings.DCBlock != old.DCBlock) distortion.setDCBlocker(chainSettings.DCBlock);
 
-    // pre-gain
-    leftChain.get<ChainPositions::PreGain>().setGainDecibels(chainSettings.PreGain);
-    rightChain.get<ChainPositions::PreGain>().setGainDecibels(chainSettings.PreGain);
+    // bands
+    if (forceUpdate || chainSettings.NumBands != old.NumBands) distortion.setNumBands(chainSettings.NumBands);
+    for (int i = 0; i < MaxBands - 1; i++) {
+        if (forceUpdate || chainSettings.CrossoverFreq[i] != old.CrossoverFreq[i]) distortion.setCrossoverFrequency(i, chainSettings.CrossoverFreq[i]);
+    }
+    for (int band = 0; band < MaxBands; band++) {
+        if (forceUpdate || chainSettings.WaveShapeFunction[band] != old.WaveShapeFunction[band] || chainSettings.WaveShapeAmount[band] != old.WaveShapeAmount[band]) {
+            distortion.setBandWaveShaper(band, static_cast<WaveShaperFunction>(chainSettings.WaveShapeFunction[band]), chainSettings.WaveShapeAmount[band]);
+        }
+        if (forceUpdate || chainSettings.BandGain[band] != old.BandGain[band]) distortion.setBandGain(band, chainSettings.BandGain[band]);
+    }
 
-    // bias
-    leftChain.get<ChainPositions::DistBias>().setBias(chainSettings.Bias);
-    rightChain.get<ChainPositions::DistBias>().setBias(chainSettings.Bias);
+    // mid/side
+    if (forceUpdate || chainSettings.MidSide != old.MidSide) distortion.setMidSide(chainSettings.MidSide);
+    if (forceUpdate || chainSettings.SideWaveShapeFunction != old.SideWaveShapeFunction || chainSettings.SideWaveShapeAmount != old.SideWaveShapeAmount) {
+        distortion.setSideWaveShaper(static_cast<WaveShaperFunction>(chainSettings.SideWaveShapeFunction), chainSettings.SideWaveShapeAmount);
+    }
+    if (forceUpdate || chainSettings.SideGain != old.SideGain) distortion.setSideGain(chainSettings.SideGain);
 
-    // waveshaper
-    WaveShaperFunction waveShapeFunction = static_cast<WaveShaperFunction>(chainSettings.WaveShapeFunction);
-    auto& waveShaperFunction = getWaveshaperFunction(waveShapeFunction, chainSettings.WaveShapeAmount);
-    leftChain.get<ChainPositions::DistWaveshaper>().functionToUse = waveShaperFunction;
-    rightChain.get<ChainPositions::DistWaveshaper>().functionToUse = waveShaperFunction;
+    // dynamic drive
+    if (forceUpdate || chainSettings.EnvAmount != old.EnvAmount) distortion.setEnvelopeAmount(chainSettings.EnvAmount);
+    if (forceUpdate || chainSettings.EnvDrive != old.EnvDrive) distortion.setEnvelopeDrive(chainSettings.EnvDrive);
+    if (forceUpdate || chainSettings.EnvAttack != old.EnvAttack) envelopeFollower.setAttack(chainSettings.EnvAttack);
+    if (forceUpdate || chainSettings.EnvRelease != old.EnvRelease) envelopeFollower.setRelease(chainSettings.EnvRelease);
+    if (forceUpdate || chainSettings.EnvDetector != old.EnvDetector) envelopeFollower.setDetector(static_cast<EnvelopeDetector>(chainSettings.EnvDetector));
 
-    // post-gain
-    leftChain.get<ChainPositions::PostGain>().setGainDecibels(chainSettings.PostGain);
-    rightChain.get<ChainPositions::PostGain>().setGainDecibels(chainSettings.PostGain);
+    appliedSettings = chainSettings;
+    if (phaseModeChanged) updateLatency();
 }
 
 //==============================================================================
 //==============================================================================
 //==============================================================================
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts) {
-    ChainSettings settings;
 
-    settings.LoCutFreq = apvts.getRawParameterValue("LoCutFreq")->load();
-    settings.LoCutSlope = static_cast<FilterSlope>(apvts.getRawParameterValue("LoCutSlope")->load());
-    settings.PeakFreq = apvts.getRawParameterValue("PeakFreq")->load();
-    settings.PeakGain = apvts.getRawParameterValue("PeakGain")->load();
-    settings.PeakQ = apvts.getRawParameterValue("PeakQ")->load();
-    settings.HiCutFreq = apvts.getRawParameterValue("HiCutFreq")->load();
-    settings.HiCutSlope = static_cast<FilterSlope>(apvts.getRawParameterValue("HiCutSlope")->load());
+// filter and crossover coefficients are the expensive part of a parameter change
+static void holdFilterSettings(ChainSettings& settings, const ChainSettings& applied) {
+    settings.LoCutFreq = applied.LoCutFreq;
+    settings.LoCutSlope = applied.LoCutSlope;
+    settings.PeakFreq = applied.PeakFreq;
+    settings.PeakGain = applied.PeakGain;
+    settings.PeakQ = applied.PeakQ;
+    settings.HiCutFreq = applied.HiCutFreq;
+    settings.HiCutSlope = applied.HiCutSlope;
+    settings.CrossoverFreq = applied.CrossoverFreq;
+}
+
+ChainSettings GnomeDistortAudioProcessor::getCompensatedSettings() const {
+    ChainSettings chainSettings = getChainSettings(apvts);
+    if (chainSettings.AutoGain) chainSettings.PostGain += autoGain.getCompensation();
+    return chainSettings;
+}
 
-    settings.PreGain = apvts.getRawParameterValue("PreGain")->load();
-    settings.Bias = apvts.getRawParameterValue("Bias")->load();
-    settings.WaveShapeAmount = apvts.getRawParameterValue("WaveShapeAmount")->load();
-    settings.WaveShapeFunction = static_cast<WaveShaperFunction>(apvts.getRawParameterValue("WaveShapeFunction")->load());
-    settings.PostGain = apvts.getRawParameterValue("PostGain")->load();
-    settings.Mix = apvts.getRawParameterValue("DryWet")->load();
+void GnomeDistortAudioProcessor::tapAnalyzers(AnalyzerTap point, const float* samples, int numSamples, float gain) {
+    if (!isAnalyzerFed) return;
+    if (isPreAnalyzerFed && preTap == point) leftPreProcessingFifo.update(samples, numSamples, gain);
+    if (postTap == point) leftPostProcessingFifo.update(samples, numSamples, gain);
+}
 
-    return settings;
+static bool isSilent(const juce::AudioBuffer<float>& buffer, int numChannels) {
+    if (buffer.hasBeenCleared()) return true;
+    for (int channel = 0; channel < numChannels; channel++) {
+        if (buffer.getMagnitude(channel, 0, buffer.getNumSamples()) > GnomeDistortAudioProcessor::SilenceThreshold) return false;
+    }
+    return true;
 }
 
+
 void GnomeDistortAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
@@ -250,22 +243,73 @@ void GnomeDistortAudioProcessor::prepareToPlay(double sampleRate, int samplesPer
     spec.sampleRate = sampleRate;
     leftChain.prepare(spec);
     rightChain.prepare(spec);
-
-    // init settings
-    ChainSettings chainSettings = getChainSettings(apvts);
-    updateSettings(chainSettings, sampleRate, leftChain, rightChain);
+    juce::dsp::ProcessSpec stereoSpec = spec;
+    stereoSpec.numChannels = 2;
+    linearPhase.prepare(stereoSpec);
+    distortion.prepare(stereoSpec);
+    envelopeFollower.prepare(sampleRate, samplesPerBlock);
+    envelope.assign(samplesPerBlock, 0.f);
+    modulation.prepare(sampleRate);
+    peakTable.prepare(sampleRate, apvts.getRawParameterValue("PeakGain")->load(), apvts.getRawParameterValue("PeakQ")->load());
+    cutTables = cutRegistry->acquire(sampleRate);
+    autoGain.prepare();
+
+    // init settings; the steepest slope first, so every filter holds a biquad before its state gets allocated on reset
+    ChainSettings chainSettings = getCompensatedSettings();
+    ChainSettings steepest = chainSettings;
+    steepest.LoCutSlope = FilterSlope::Slope48;
+    steepest.HiCutSlope = FilterSlope::Slope48;
+    updateSettings(steepest, true);
+    updateSettings(chainSettings, true);
+    rampStartSettings = chainSettings;
+    leftChain.reset();
+    rightChain.reset();
+    linearPhase.reset();
 
     drywetL.prepare(spec);
     drywetR.prepare(spec);
     drywetL.setMixingRule(juce::dsp::DryWetMixingRule::linear);
     drywetR.setMixingRule(juce::dsp::DryWetMixingRule::linear);
-    drywetL.setWetMixProportion(chainSettings.Mix);
-    drywetR.setWetMixProportion(chainSettings.Mix);
+    const bool isBypassed = apvts.getRawParameterValue("Bypass")->load() > 0.5f;
+    drywetL.setWetMixProportion(isBypassed ? 0.f : chainSettings.Mix);
+    drywetR.setWetMixProportion(isBypassed ? 0.f : chainSettings.Mix);
+    drywetL.reset();
+    drywetR.reset();
+    updateLatency();
+
+    bypassFade.reset(sampleRate, MixerRampSeconds);
+    bypassFade.setCurrentAndTargetValue(isBypassed ? 0.f : 1.f);
+    programFade.reset(sampleRate, ProgramFadeSeconds);
+    programFade.setCurrentAndTargetValue(1.f);
+    programChanged.set(false);      // already running with the current values
+    isProgramFading = false;
+    samplesOfSilence = 0;
+    isIdle = false;
 
     leftPreProcessingFifo.prepare(samplesPerBlock);
     leftPostProcessingFifo.prepare(samplesPerBlock);
+    transferScope.prepare(samplesPerBlock);
+}
+
+
+int GnomeDistortAudioProcessor::getChainLatency() const {
+    // apart from the linear phase FIR all stages are IIR filters or memoryless, none of them delays the signal
+    return appliedSettings.LinearPhase ? linearPhase.getLatency() : 0;
+}
+
+void GnomeDistortAudioProcessor::updateLatency() {
+    const int latency = getChainLatency();
+    jassert(latency <= MaxLatencySamples);
+    latencySamples = latency;
+    drywetL.setWetLatency((float)latency);     // dry signal is delayed to line up with the processed one
+    drywetR.setWetLatency((float)latency);
+    if (juce::MessageManager::existsAndIsCurrentThread()) setLatencySamples(latency);
+    else triggerAsyncUpdate();                  // hosts expect latency changes on the message thread
 }
 
+void GnomeDistortAudioProcessor::handleAsyncUpdate() {
+    setLatencySamples(latencySamples.get());
+}
 
 void GnomeDistortAudioProcessor::releaseResources() {
     // When playback stops, you can use this as an opportunity to free up any
@@ -283,13 +327,20 @@ bool GnomeDistortAudioProcessor::isBusesLayoutSupported(const BusesLayout& layou
         && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
         return false;
 
+    // optional sidechain for the dynamic drive
+    if (layouts.inputBuses.size() > 1) {
+        const auto sidechain = layouts.getChannelSet(true, 1);
+        if (!sidechain.isDisabled() && sidechain != juce::AudioChannelSet::mono() && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
     return true;
 }
 #endif
 
 void GnomeDistortAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
+    auto totalNumInputChannels = getMainBusNumInputChannels();   // the sidechain is only read by the envelope follower
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     // In case we have more outputs than inputs, this code clears any output
@@ -301,32 +352,149 @@ void GnomeDistortAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // prepare settings before processing audio
-    ChainSettings chainSettings = getChainSettings(apvts);
-    updateSettings(chainSettings, getSampleRate(), leftChain, rightChain);
-
-    if (buffer.getMagnitude(0, buffer.getNumSamples() / 10) > 0) {              // mitigate signal generated by Bias for no input
-        // run audio through ProcessorChain
-        juce::dsp::AudioBlock<float> block(buffer);                             // separating left and right channel
-        auto leftBlock = block.getSingleChannelBlock(0);
-        auto rightBlock = block.getSingleChannelBlock(1);
+    const int numSamples = buffer.getNumSamples();
+
+    juce::dsp::AudioBlock<float> block(buffer);                                 // separating left and right channel
+    auto leftBlock = block.getSingleChannelBlock(0);
+    auto rightBlock = block.getSingleChannelBlock(1);
+
+    // bypass: the mixing stage fades to the latency compensated dry signal, processing is skipped once fully bypassed
+    const bool isBypassed = apvts.getRawParameterValue("Bypass")->load() > 0.5f;
+    bypassFade.setTargetValue(isBypassed ? 0.f : 1.f);
+    if (isBypassed && !bypassFade.isSmoothing()) {
+        isIdle = true;
+        if (latencySamples.get() > 0) {       // keep delaying the signal by the reported latency
+            drywetL.pushDrySamples(leftBlock);
+            drywetR.pushDrySamples(rightBlock);
+            drywetL.mixWetSamples(leftBlock);
+            drywetR.mixWetSamples(rightBlock);
+        }
+        return;
+    }
+    bypassFade.skip(numSamples);
+
+    // silence: keep processing while the filters ring out, then skip everything until there is signal again
+    if (isSilent(buffer, totalNumInputChannels)) samplesOfSilence = juce::jmin(samplesOfSilence + numSamples, SilenceCountLimit);
+    else samplesOfSilence = 0;
+    const int tailSamples = (int)(getFilterRingOutSeconds(appliedSettings) * getSampleRate()) + 2 * latencySamples.get();
+    if (samplesOfSilence > tailSamples + numSamples) {
+        isIdle = true;
+        buffer.clear();     // also flags the buffer as cleared, so the host knows it is silent
+        return;
+    }
+    if (isIdle) {           // resume from a clean state instead of whatever the stages held when going idle
+        isIdle = false;
+        leftChain.reset();
+        rightChain.reset();
+        linearPhase.reset();
+        distortion.reset();
+        envelopeFollower.reset();
+        drywetL.reset();
+        drywetR.reset();
+    }
 
-        leftPreProcessingFifo.update(buffer);
+    // parameters are read once per block; continuous ones which moved since the last block are ramped towards their
+    // new value in sub-blocks, so automation is followed at SubBlockSize resolution instead of the host buffer size
+    const bool hasCompensationChange = autoGain.pullChange();     // a new estimate ramps in like a PostGain change
+    ChainSettings chainSettings = getCompensatedSettings();
+    const ChainSettings startSettings = rampStartSettings;
+    const bool hasParameterChange = parametersChanged.compareAndSetBool(false, true) || hasCompensationChange;
+
+    // program change: the old settings are held until the output has faded out, the new ones apply without ramp
+    if (programChanged.compareAndSetBool(false, true) && !isProgramFading) {
+        isProgramFading = true;
+        programFadeSettings = appliedSettings;
+        programFade.setTargetValue(0.f);
+    }
+    bool isProgramSwitch = false;
+    if (isProgramFading) {
+        if (programFade.getCurrentValue() == 0.f) {     // silent since the end of the last block
+            isProgramFading = false;
+            isProgramSwitch = true;
+            programFade.setTargetValue(1.f);
+            leftChain.reset();
+            rightChain.reset();
+            distortion.reset();
+            envelopeFollower.reset();
+        } else chainSettings = programFadeSettings;
+    }
 
-        drywetL.setWetMixProportion(chainSettings.Mix);
-        drywetR.setWetMixProportion(chainSettings.Mix);
-        drywetL.pushDrySamples(leftBlock);
-        drywetR.pushDrySamples(rightBlock);
+    const bool isRamping = hasParameterChange && numSamples > SubBlockSize && !chainSettings.Economy && !isProgramFading && !isProgramSwitch;
+    const double blockSeconds = juce::jmax(1, getBlockSize()) / getSampleRate();  // the prepared size, so instances share the tick length
+    if (chainSettings.Economy && !isProgramSwitch && !loadScheduler->isTurn(schedulerSlot, blockSeconds, lastSchedulerTurn)) {
+        holdFilterSettings(chainSettings, rampStartSettings);   // picked up again on the next turn, as they still differ then
+    }
+    rampStartSettings = chainSettings;
+    // modulation runs at SubBlockSize resolution too; economy instances evaluate it once per block
+    modulation.beginBlock(getPlayHead(), numSamples);
+    const bool isModulated = modulation.isActive(chainSettings);
+    const bool isSubdivided = isRamping || (isModulated && !chainSettings.Economy);
+    distortion.setUseFastMath(chainSettings.Precision == MathPrecision::PrecisionFast
+                              || (chainSettings.Precision == MathPrecision::PrecisionAuto && !isNonRealtime()));
+
+    // run audio through ProcessorChain
+    isAnalyzerFed = isAnalyzerOpen.load() && apvts.getRawParameterValue("DisplayON")->load() > 0.5f;
+    isPreAnalyzerFed = isAnalyzerFed && (int)apvts.getRawParameterValue("DisplayMode")->load() != AnalyzerMode::ModeSpectrogram;
+    preTap = static_cast<AnalyzerTap>(apvts.getRawParameterValue("AnalyzerPreTap")->load());
+    postTap = static_cast<AnalyzerTap>(apvts.getRawParameterValue("AnalyzerPostTap")->load());
+    tapAnalyzers(TapInput, buffer.getReadPointer(0), numSamples);
+
+    drywetL.setWetMixProportion(isBypassed ? 0.f : chainSettings.Mix);
+    drywetR.setWetMixProportion(isBypassed ? 0.f : chainSettings.Mix);
+    drywetL.pushDrySamples(leftBlock);
+    drywetR.pushDrySamples(rightBlock);
+
+    if (chainSettings.LinearPhase) {     // filters come first in the chain; the FIR is not ramped, a new one is crossfaded in
+        if (!appliedSettings.LinearPhase) linearPhase.reset();
+        auto stereoBlock = block.getSubsetChannelBlock(0, 2);
+        linearPhase.process(juce::dsp::ProcessContextReplacing<float>(stereoBlock));
+    }
 
-        juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);       // create ProcessContext for both channels
-        juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    // the envelope of the distortion input, or of the sidechain if selected and connected
+    const auto sidechain = getBusBuffer(buffer, true, 1);
+    const bool useSidechain = chainSettings.EnvSidechain && sidechain.getNumChannels() > 0;
+    const bool isEnvelopeUsed = distortion.isEnvelopeActive() || modulation.usesEnvelope(chainSettings);
+    if (!isEnvelopeUsed) envelopeFollower.reset();     // starts from silence when switched on
+    distortion.setTransferScope(transferScope.isActive() ? &transferScope : nullptr);
+
+    const int step = std::min(isSubdivided ? SubBlockSize : numSamples, (int)envelope.size());
+    for (int start = 0; start < numSamples; start += step) {
+        const int length = std::min(step, numSamples - start);
+        ChainSettings subBlockSettings = isRamping ? interpolateChainSettings(startSettings, chainSettings, (float)(start + length) / numSamples) : chainSettings;
+        if (isModulated) modulation.apply(subBlockSettings, start, envelopeFollower.getCurrentValue());
+        updateSettings(subBlockSettings);
+
+        auto leftSubBlock = leftBlock.getSubBlock(start, length);
+        auto rightSubBlock = rightBlock.getSubBlock(start, length);
+        juce::dsp::ProcessContextReplacing<float> leftContext(leftSubBlock);    // create ProcessContext for both channels
+        juce::dsp::ProcessContextReplacing<float> rightContext(rightSubBlock);
         leftChain.process(leftContext);                                         // process
         rightChain.process(rightContext);
-        leftPostProcessingFifo.update(buffer);
+        tapAnalyzers(TapFiltered, leftSubBlock.getChannelPointer(0), length);
+        auto stereoSubBlock = block.getSubsetChannelBlock(0, 2).getSubBlock(start, length);
+        const float* envelopeData = nullptr;
+        if (isEnvelopeUsed) {
+            const float* detectorInput[2] = { stereoSubBlock.getChannelPointer(0), stereoSubBlock.getChannelPointer(1) };
+            int numDetectorChannels = 2;
+            if (useSidechain) {
+                numDetectorChannels = std::min(2, sidechain.getNumChannels());
+                for (int channel = 0; channel < numDetectorChannels; channel++) detectorInput[channel] = sidechain.getReadPointer(channel, start);
+            }
+            envelopeFollower.process(detectorInput, numDetectorChannels, length, envelope.data());
+            envelopeData = envelope.data();
+        }
+        distortion.process(juce::dsp::ProcessContextReplacing<float>(stereoSubBlock), envelopeData);
+        tapAnalyzers(TapDistorted, leftSubBlock.getChannelPointer(0), length, juce::Decibels::decibelsToGain(-subBlockSettings.PostGain));
+    }
+    tapAnalyzers(TapOutput, buffer.getReadPointer(0), numSamples);
 
-        drywetL.mixWetSamples(leftBlock);
-        drywetR.mixWetSamples(rightBlock);
+    drywetL.mixWetSamples(leftBlock);
+    drywetR.mixWetSamples(rightBlock);
+    if (isProgramFading || programFade.isSmoothing()) programFade.applyGain(buffer, numSamples);
 
+    // last block before going idle: fade out what Bias leaves behind, unless the DC blocker has already removed it
+    if (samplesOfSilence > tailSamples && !appliedSettings.DCBlock) {
+        buffer.applyGainRamp(0, numSamples, 1.f, 0.f);
     }
 }
 
@@ -348,8 +516,7 @@ void GnomeDistortAudioProcessor::getStateInformation(juce::MemoryBlock& destData
     // You could do that either as raw data, or use the XML or ValueTree classes
     // as intermediaries to make it easy to save and load complex data.
 
-    juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    presets.writeState(destData);
 }
 
 void GnomeDistortAudioProcessor::setStateInformation(const void* data, int sizeInBytes) {
@@ -357,11 +524,12 @@ void GnomeDistortAudioProcessor::setStateInformation(const void* data, int sizeI
     // whose contents will have been created by the getStateInformation() call.
 
 
-    auto state = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (state.isValid()) {
-        apvts.replaceState(state);
-        updateSettings(getChainSettings(apvts), getSampleRate(), leftChain, rightChain);
-    }
+    // only parameter values are set; the audio thread picks them up like any other change (prepareToPlay if not running)
+    programChanged.set(true);
+    if (presets.restoreState(data, sizeInBytes)) return;
+
+    auto state = juce::ValueTree::readFromData(data, sizeInBytes);     // sessions saved before the binary state
+    if (state.isValid()) apvts.replaceState(state);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout GnomeDistortAudioProcessor::createParameterLayout() {
@@ -393,6 +561,64 @@ juce::AudioProcessorValueTreeState::ParameterLayout GnomeDistortAudioProcessor::
 
     layout.add(std::make_unique<juce::AudioParameterBool>("DisplayON", "DisplayON", true));
     layout.add(std::make_unique<juce::AudioParameterBool>("DisplayHQ", "DisplayHQ", true));
+    layout.add(std::make_unique<juce::AudioParameterBool>("Bypass", "Bypass", false));
+    layout.add(std::make_unique<juce::AudioParameterBool>("LinearPhase", "LinearPhase", false));
+
+    // multiband distortion; band 1 uses WaveShapeAmount and WaveShapeFunction
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Bands", "Bands", juce::StringArray{ "1", "2", "3", "4" }, 0));
+    const float defaultCrossovers[MaxBands - 1] = { 200.f, 1000.f, 5000.f };
+    for (int i = 1; i < MaxBands; i++) {
+        const juce::String id = "CrossoverFreq" + juce::String(i);
+        layout.add(std::make_unique<juce::AudioParameterFloat>(id, id, juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), defaultCrossovers[i - 1]));
+    }
+    for (int band = 1; band <= MaxBands; band++) {
+        const juce::String prefix = "Band" + juce::String(band);
+        if (band > 1) {
+            layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "WaveShapeAmount", prefix + "WaveShapeAmount", juce::NormalisableRange<float>(0.f, 0.990f, 0.01f, 0.75f), 0.f));
+            layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + "WaveShapeFunction", prefix + "WaveShapeFunction", WaveShaperOptions, 0));
+        }
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Gain", prefix + "Gain", juce::NormalisableRange<float>(-32.f, 8.f, 0.5f, 1.f), 0.f));
+    }
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Precision", "Precision", juce::StringArray{ "Auto", "Exact", "Fast" }, 0));
+    layout.add(std::make_unique<juce::AudioParameterBool>("Economy", "Economy", false));
+
+    // mid/side; WaveShapeAmount and WaveShapeFunction then shape the mid signal, SideGain sets the width
+    layout.add(std::make_unique<juce::AudioParameterBool>("MidSide", "MidSide", false));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("SideWaveShapeAmount", "SideWaveShapeAmount", juce::NormalisableRange<float>(0.f, 0.990f, 0.01f, 0.75f), 0.f));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("SideWaveShapeFunction", "SideWaveShapeFunction", WaveShaperOptions, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("SideGain", "SideGain", juce::NormalisableRange<float>(-32.f, 8.f, 0.5f, 1.f), 0.f));
+
+    // dynamic drive; at full envelope EnvAmount is added to the waveshaper amounts and EnvDrive to the pre-gain
+    layout.add(std::make_unique<juce::AudioParameterFloat>("EnvAmount", "EnvAmount", juce::NormalisableRange<float>(-0.990f, 0.990f, 0.01f, 1.f), 0.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("EnvDrive", "EnvDrive", juce::NormalisableRange<float>(0.f, 24.f, 0.5f, 1.f), 0.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("EnvAttack", "EnvAttack", juce::NormalisableRange<float>(0.1f, 200.f, 0.1f, 0.3f), 10.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("EnvRelease", "EnvRelease", juce::NormalisableRange<float>(5.f, 2000.f, 1.f, 0.3f), 150.f));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("EnvDetector", "EnvDetector", juce::StringArray{ "Peak", "RMS" }, 0));
+    layout.add(std::make_unique<juce::AudioParameterBool>("EnvSidechain", "EnvSidechain", false));
+
+    // modulation matrix; depth is the offset in the target's normalised range at full LFO/envelope output
+    for (int lfo = 1; lfo <= NumLFOs; lfo++) {
+        const juce::String prefix = "LFO" + juce::String(lfo);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + "Rate", prefix + "Rate", LFORateOptions, 4));
+        layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + "Shape", prefix + "Shape", LFOShapeOptions, 0));
+    }
+    for (int slot = 1; slot <= NumModulationSlots; slot++) {
+        const juce::String prefix = "Mod" + juce::String(slot);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + "Source", prefix + "Source", ModulationSourceOptions, 0));
+        layout.add(std::make_unique<juce::AudioParameterChoice>(prefix + "Target", prefix + "Target", ModulationMatrix::getTargetOptions(), 0));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Depth", prefix + "Depth", juce::NormalisableRange<float>(-1.f, 1.f, 0.01f, 1.f), 0.f));
+    }
+
+    // removes DC after the waveshaper, so Bias and asymmetric curves don't cost headroom downstream
+    layout.add(std::make_unique<juce::AudioParameterBool>("DCBlock", "DCBlock", false));
+    // PostGain follows the estimated loudness change of the waveshaper; PostGain itself stays as a trim on top
+    layout.add(std::make_unique<juce::AudioParameterBool>("AutoGain", "AutoGain", false));
+
+    // where in the chain the pre and post analyzer curves are taken
+    layout.add(std::make_unique<juce::AudioParameterChoice>("AnalyzerPreTap", "AnalyzerPreTap", AnalyzerTapOptions, AnalyzerTap::TapInput));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("AnalyzerPostTap", "AnalyzerPostTap", AnalyzerTapOptions, AnalyzerTap::TapOutput));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("DisplayMode", "DisplayMode", AnalyzerModeOptions, AnalyzerMode::ModeInstant));
 
     return layout;
 }
@@ -10,116 +10,21 @@
 
 #include <JuceHeader.h>
 #include "Helpers/SingleChannelSampleFifo.h"
-
-enum FilterSlope {
-    Slope12,
-    Slope24,
-    Slope36,
-    Slope48
-};
-
-enum WaveShaperFunction {
-    HardClip,
-    SoftClip,
-    Cracked,
-    GNOME,
-    Warm,
-    Quantize,
-    Fuzz,
-    Hollowing,
-    Sin,
-    Rash,
-    Spiked,
-    Titruff
-};
-
-const juce::StringArray WaveShaperOptions = {
-    "Hard Clip",
-    "Soft Clip",
-    "Cracked",
-    "GNOME",
-    "Warm",
-    "Quantize",
-    "Fuzz",
-    "Hollowing",
-    "Sin",
-    "Rash",
-    "Spiked",
-    "Titruff"
-};
-
-enum TreeParameter {
-    PosLoCutFreq,
-    PosLoCutSlope,
-    PosPeakFreq,
-    PosPeakGain,
-    PosPeakQ,
-    PosHiCutFreq,
-    PosHiCutSlope,
-    PosPreGain,
-    PosBias,
-    PosWaveShapeAmount,
-    PosWaveShapeFunction,
-    PosPostGain,
-    PosDryWet,
-    PosDisplayON,
-    PosDisplayHQ
-};
-
-struct ChainSettings {
-    float LoCutFreq{ 0 }, PeakFreq{ 0 }, PeakGain{ 0 }, PeakQ{ 0 }, HiCutFreq{ 0 }, PreGain{ 0 }, Bias{ 0 }, WaveShapeAmount{ 0 }, PostGain{ 0 }, Mix{ 0 };
-    int LoCutSlope{ FilterSlope::Slope12 }, HiCutSlope{ FilterSlope::Slope12 }, WaveShapeFunction{ WaveShaperFunction::HardClip };
-};
-
-using Filter = juce::dsp::IIR::Filter<float>;   // alias for Filters
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;     // ProcessorChain which allows to automatically run signal through all specified DSP instances (4 filter slope types)
-using Gain = juce::dsp::Gain<float>;
-using Bias = juce::dsp::Bias<float>;
-using DistWaveShape = juce::dsp::WaveShaper<float, std::function<float(float)>>;
-
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter, Gain, Bias, DistWaveShape, Gain>; // complete effect chain for one channel
-enum ChainPositions {
-    LoCut,
-    Peak,
-    HiCut,
-    PreGain,
-    DistBias,
-    DistWaveshaper,
-    PostGain
-};
-
-using Coefficients = Filter::CoefficientsPtr;
-void updateCoefficients(Coefficients& old, const Coefficients& replace);
-Coefficients generatePeakFilter(const ChainSettings& chainSettings, double sampleRate);
-inline auto generateLoCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(     // create array of filter coefficients for 4 possible slopes
-                                                                                       chainSettings.LoCutFreq, sampleRate, (chainSettings.LoCutSlope + 1) * 2);
-}
-inline auto generateHiCutFilter(const ChainSettings& chainSettings, double sampleRate) {
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(     // create array of filter coefficients for 4 possible slopes
-                                                                                      chainSettings.HiCutFreq, sampleRate, (chainSettings.HiCutSlope + 1) * 2);
-}
-// template function can be used on left AND right channel
-template<typename ChainType, typename CoefficientsType> static void updateCutFilter(ChainType& filter, const CoefficientsType& cutCoefficients, const FilterSlope& slope) {
-    filter.template setBypassed<0>(true);     // bypass all 4 possible filters (one for every possible slope)
-    filter.template setBypassed<1>(true);
-    filter.template setBypassed<2>(true);
-    filter.template setBypassed<3>(true);
-    switch (slope) {
-        case Slope48: *filter.template get<3>().coefficients = *cutCoefficients[3]; filter.setBypassed<3>(false);
-        case Slope36: *filter.template get<2>().coefficients = *cutCoefficients[2]; filter.setBypassed<2>(false);
-        case Slope24: *filter.template get<1>().coefficients = *cutCoefficients[1]; filter.setBypassed<0>(false);
-        case Slope12: *filter.template get<0>().coefficients = *cutCoefficients[0]; filter.setBypassed<0>(false);
-    }
-}
-
-std::function<float(float)> getWaveshaperFunction(WaveShaperFunction& func, float& amount);
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
+#include "Helpers/LoadScheduler.h"
+#include "Helpers/PresetManager.h"
+#include "Helpers/TransferScope.h"
+#include "DSP/Chain.h"
+#include "DSP/LinearPhaseFilter.h"
+#include "DSP/DistortionEngine.h"
+#include "DSP/EnvelopeFollower.h"
+#include "DSP/ModulationMatrix.h"
+#include "DSP/CoefficientTables.h"
+#include "DSP/AutoGain.h"
 
 //==============================================================================
 /**
 */
-class GnomeDistortAudioProcessor : public juce::AudioProcessor
+class GnomeDistortAudioProcessor : public juce::AudioProcessor, public juce::AudioProcessorParameter::Listener, private juce::AsyncUpdater
 #if JucePlugin_Enable_ARA
     , public juce::AudioProcessorARAExtension
 #endif
@@ -150,6 +55,7 @@ public:
     bool producesMidi() const override;
     bool isMidiEffect() const override;
     double getTailLengthSeconds() const override;
+    juce::AudioProcessorParameter* getBypassParameter() const override;
 
     //==============================================================================
     int getNumPrograms() override;
@@ -162,16 +68,67 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {} // not implemented
+
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState apvts{ *this, nullptr, "Parameters", createParameterLayout() };
     static juce::StringArray getSlopeOptions();
 
+    static constexpr float SilenceThreshold = 0.000001f;    // -120 dBFS
+    int getSchedulerSlot() const { return schedulerSlot; }
+    PresetManager presets{ *this };     // host programs; switching or restoring crossfades through ProgramFadeSeconds
     using BlockType = juce::AudioBuffer<float>;
-    SingleChannelSampleFifo<BlockType> leftPreProcessingFifo{ Channel::Left }, leftPostProcessingFifo{ Channel::Left };
+    SingleChannelSampleFifo<BlockType> leftPreProcessingFifo{ Channel::Left }, leftPostProcessingFifo{ Channel::Left };   // see AnalyzerTap
+    std::atomic<bool> isAnalyzerOpen{ false };  // the FIFOs are only fed while an analyzer is open and "DisplayON"
+    TransferScope transferScope;        // left (or mid) channel through the first band's waveshaper, for DisplayGraph
 
 private:
     MonoChain leftChain, rightChain;    // stereo
-    juce::dsp::DryWetMixer<float> drywetL, drywetR;
+    LinearPhaseFilter linearPhase{ apvts };     // replaces the chains' filters when "LinearPhase" is on
+    DistortionEngine distortion;                // stereo, runs after the filter chains
+    EnvelopeFollower envelopeFollower;          // dynamic drive, detects the distortion input or the sidechain bus
+    std::vector<float> envelope;                // one value per sample of a sub-block, sized in prepareToPlay
+    ModulationMatrix modulation{ apvts };       // LFOs and envelope, applied to the settings of every sub-block
+    PeakCoefficientTable peakTable;             // peak filter designs across frequency for the current gain and Q, built off the audio thread
+    juce::SharedResourcePointer<CutCoefficientRegistry> cutRegistry;
+    std::shared_ptr<const CutCoefficientTables> cutTables;     // for the current sample rate, shared with other instances
+    AutoGain autoGain{ apvts };                 // estimated in the background, folded into PostGain of the settings read per block
+    ChainSettings getCompensatedSettings() const;
+    static constexpr int MaxLatencySamples = 8192;
+    static constexpr double MixerRampSeconds = 0.05;   // ramp length DryWetMixer uses for its mix proportion
+    juce::dsp::DryWetMixer<float> drywetL{ MaxLatencySamples }, drywetR{ MaxLatencySamples };
+    juce::Atomic<int> latencySamples{ 0 };
+    int getChainLatency() const;
+    void updateLatency();
+    void handleAsyncUpdate() override;          // reports latency changes which happened on the audio thread
+
+    static constexpr int SubBlockSize = 32;     // resolution in samples at which automation is followed within a host block
+    ChainSettings appliedSettings;              // settings the chains are currently running with
+    ChainSettings rampStartSettings;            // same without modulation, where parameter ramps start from
+    juce::Atomic<bool> parametersChanged{ true };
+    void updateSettings(const ChainSettings& chainSettings, bool forceUpdate = false);
+
+    juce::SharedResourcePointer<LoadScheduler> loadScheduler;   // economy: filter coefficients only follow on this instance's turn
+    const int schedulerSlot = loadScheduler->acquireSlot();
+    juce::int64 lastSchedulerTurn = LoadScheduler::NoTurn;
+
+    juce::SmoothedValue<float> bypassFade;      // 1 = processed, 0 = bypassed; follows the mixer's ramp to know when it is done
+    // program change / state restore: fade out with the old settings, switch at the start of the next block, fade in
+    static constexpr double ProgramFadeSeconds = 0.005;
+    juce::Atomic<bool> programChanged{ false };
+    juce::SmoothedValue<float> programFade;
+    ChainSettings programFadeSettings;          // settings held while fading out
+    bool isProgramFading = false;
+    static constexpr int SilenceCountLimit = 1 << 30;
+    int samplesOfSilence = 0;
+    bool isIdle = false;                        // chains were skipped (silence or bypass) and have to start over
+
+    // analyzer taps, read once per block; every tap in use costs one copy of the left channel into its FIFO
+    AnalyzerTap preTap = TapInput, postTap = TapOutput;
+    bool isAnalyzerFed = false, isPreAnalyzerFed = false;    // the spectrogram only shows the post curve
+    void tapAnalyzers(AnalyzerTap point, const float* samples, int numSamples, float gain = 1.f);
 
 
     //==============================================================================
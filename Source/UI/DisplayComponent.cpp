@@ -31,9 +31,20 @@ leftPreFifo(&audioProcessor.leftPreProcessingFifo), leftPostFifo(&audioProcessor
         }
     }
 
+    juce::ColourGradient spectrogramGradient(COLOR_BG_VERYDARK, 0.f, 0.f, juce::Colours::white, 1.f, 0.f, false);
+    spectrogramGradient.addColour(0.4, COLOR_KNOB);
+    spectrogramGradient.addColour(0.75, juce::Colours::orange);
+    for (int i = 0; i < (int)spectrogramColours.size(); i++) {
+        spectrogramColours[i] = spectrogramGradient.getColourAtPosition((double)i / (spectrogramColours.size() - 1));
+    }
+
+    isEnabled = audioProcessor.apvts.getRawParameterValue("DisplayON")->load() > 0.5f;
+    wasEnabled = isEnabled;
+    audioProcessor.isAnalyzerOpen = true;
     updateSettings();
 }
 DisplayComponent::~DisplayComponent() {
+    audioProcessor.isAnalyzerOpen = false;
     const auto& params = audioProcessor.getParameters();
 
     for (auto param : params) {
@@ -51,6 +62,11 @@ void DisplayComponent::resized() {
     int width = bounds.getWidth();
     int height = bounds.getHeight();
     background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
+    spectrogram = Image(Image::PixelFormat::RGB, jmax(1, width), jmax(1, height), false);
+    spectrogram.clear(spectrogram.getBounds(), spectrogramColours.front());
+    spectrogramColumn = 0;
+    spectrogramFFTSize = 0;     // row mapping is rebuilt for the new height
+    updateResponseCurve();
     Graphics g(background);
 
     g.setColour(COLOR_BG_VERYDARK);
@@ -123,59 +139,52 @@ void DisplayComponent::paint(juce::Graphics& g) {
     using namespace juce;
 
     auto displayArea = getLocalBounds();
-    auto renderArea = getRenderArea();
     auto analysisArea = getAnalysisArea();
 
-    const int width = analysisArea.getWidth();
-    const double outputMin = analysisArea.getBottom();
-    const double outputMax = analysisArea.getY();
-
     g.setColour(COLOR_BG_VERYDARK);
     g.fillRect(displayArea.toFloat());
     g.drawImage(background, displayArea.toFloat());
 
     // draw signals
-    if (isEnabled) {
+    if (isEnabled && viewMode == ModeSpectrogram) {   // oldest column on the left
+        const int x = analysisArea.getX(), y = analysisArea.getY(), h = spectrogram.getHeight();
+        const int olderWidth = spectrogram.getWidth() - spectrogramColumn;
+        g.drawImage(spectrogram, x, y, olderWidth, h, spectrogramColumn, 0, olderWidth, h);
+        if (spectrogramColumn > 0) g.drawImage(spectrogram, x + olderWidth, y, spectrogramColumn, h, 0, 0, spectrogramColumn, h);
+    } else if (isEnabled) {
+        const auto toAnalysisArea = AffineTransform::translation((float)analysisArea.getX(), (float)analysisArea.getY());
         g.setColour(COLOR_KNOB);
-        postFFTPath.applyTransform(AffineTransform().translation(analysisArea.getX(), analysisArea.getY()));
-        g.strokePath(postFFTPath, PathStrokeType(2.f));
+        g.strokePath(postFFTPath, PathStrokeType(2.f), toAnalysisArea);
         g.setColour(COLOR_BG_MID);
-        preFFTPath.applyTransform(AffineTransform().translation(analysisArea.getX(), analysisArea.getY()));
-        g.strokePath(preFFTPath, PathStrokeType(2.f));
+        g.strokePath(preFFTPath, PathStrokeType(2.f), toAnalysisArea);
     }
 
-    auto& loCut = monoChain.get<ChainPositions::LoCut>();
-    auto& peak = monoChain.get<ChainPositions::Peak>();
-    auto& hiCut = monoChain.get<ChainPositions::HiCut>();
+    g.setColour(Colours::white);
+    g.strokePath(filterResponseCurve, PathStrokeType(2));   // draw path
+}
+
+void DisplayComponent::updateResponseCurve() {
+    using namespace juce;
+    auto analysisArea = getAnalysisArea();
+    const int width = analysisArea.getWidth();
+    const double outputMin = analysisArea.getBottom();
+    const double outputMax = analysisArea.getY();
     auto sampleRate = audioProcessor.getSampleRate();
+    filterResponseCurve.clear();
+    if (width <= 0 || sampleRate <= 0.0) return;
 
     // get filter magnitudes
     std::vector<double> magnitudes;
     magnitudes.resize(width);
     for (int i = 0; i < width; i++) {   // compute magnitude per pixel
-        double mag = 1.f;   // init gain magnitude
         double freq = juce::mapToLog10((double)i / (double)width, 20.0, 20000.0);
-
-        if (!loCut.isBypassed<0>()) mag *= loCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!loCut.isBypassed<1>()) mag *= loCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!loCut.isBypassed<2>()) mag *= loCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!loCut.isBypassed<3>()) mag *= loCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!hiCut.isBypassed<0>()) mag *= hiCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!hiCut.isBypassed<1>()) mag *= hiCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!hiCut.isBypassed<2>()) mag *= hiCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!hiCut.isBypassed<3>()) mag *= hiCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-
-        magnitudes[i] = Decibels::gainToDecibels(mag);
+        magnitudes[i] = Decibels::gainToDecibels(getFilterMagnitudeForFrequency(monoChain, freq, sampleRate));
     }
-    Path filterResponseCurve;
     auto map = [outputMin, outputMax](double input) { return jmap(input, -36.0, 36.0, outputMin, outputMax); };
     filterResponseCurve.startNewSubPath(analysisArea.getX(), map(magnitudes.front()));
     for (int i = 1; i < magnitudes.size(); i++) {   // set path for every pixel
         filterResponseCurve.lineTo(analysisArea.getX() + i, map(magnitudes[i]));
     }
-    g.setColour(Colours::white);
-    g.strokePath(filterResponseCurve, PathStrokeType(2));   // draw path
 }
 
 juce::Rectangle<int> DisplayComponent::getRenderArea() {
@@ -195,12 +204,10 @@ juce::Rectangle<int> DisplayComponent::getAnalysisArea() {
 
 void DisplayComponent::updateSettings() {
     ChainSettings chainSettings = getChainSettings(audioProcessor.apvts);
-    auto loCoefficients = generateLoCutFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCutFilter(monoChain.get<ChainPositions::LoCut>(), loCoefficients, static_cast<FilterSlope>(chainSettings.LoCutSlope));
-    Coefficients peakCoefficients = generatePeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    auto hiCoefficients = generateHiCutFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCutFilter(monoChain.get<ChainPositions::HiCut>(), hiCoefficients, static_cast<FilterSlope>(chainSettings.HiCutSlope));
+    updateLoCutFilter(monoChain.get<ChainPositions::LoCut>(), chainSettings, audioProcessor.getSampleRate());
+    updatePeakFilter(monoChain.get<ChainPositions::Peak>(), chainSettings, audioProcessor.getSampleRate());
+    updateHiCutFilter(monoChain.get<ChainPositions::HiCut>(), chainSettings, audioProcessor.getSampleRate());
+    updateResponseCurve();
 
     if (hasQualityChanged.compareAndSetBool(false, true)) {
         preFFTDataGenerator.changeOrder(isHQ ? FFTOrder::order8192 : FFTOrder::order2048);
@@ -217,39 +224,131 @@ void DisplayComponent::parameterValueChanged(int parameterIndex, float newValue)
     parametersChanged.set(true);
 }
 
-void DisplayComponent::generatePathFromIncomingAudio(SingleChannelSampleFifo<GnomeDistortAudioProcessor::BlockType>* fifo, juce::AudioBuffer<float>* buffer, FFTDataGenerator<std::vector<float>>* FFTGen,
-                                                     AnalyzerPathGenerator<juce::Path>* pathProducer, juce::Path* path, bool closedPath) {
-    const float negInfinity = -48.f;
-    juce::AudioBuffer<float> tempIncomingBuffer;
+bool DisplayComponent::generatePathFromIncomingAudio(SingleChannelSampleFifo<GnomeDistortAudioProcessor::BlockType>* fifo, juce::AudioBuffer<float>* buffer, FFTDataGenerator<std::vector<float>>* FFTGen,
+                                                     AnalyzerPathGenerator<juce::Path>* pathProducer, juce::Path* path, DisplayCurve* displayCurve,
+                                                     bool closedPath, bool isSpectrogramSource) {
+    const float negInfinity = AnalyzerFloor;
+    bool hasNewAudio = false;
     while (fifo->getNumCompletedBuffersAvailable() > 0) {
-        if (fifo->getAudioBuffer(tempIncomingBuffer)) {  // read temp buffer, push into pre-processing buffer
-            int size = tempIncomingBuffer.getNumSamples();
+        if (fifo->getAudioBuffer(incomingBuffer)) {  // read incoming buffer, push into pre-processing buffer
+            int size = incomingBuffer.getNumSamples();
             juce::FloatVectorOperations::copy(buffer->getWritePointer(0, 0), buffer->getReadPointer(0, size), buffer->getNumSamples() - size);
-            juce::FloatVectorOperations::copy(buffer->getWritePointer(0, buffer->getNumSamples() - size), tempIncomingBuffer.getReadPointer(0, 0), size);
-            FFTGen->produceFFTData(*buffer, negInfinity);
+            juce::FloatVectorOperations::copy(buffer->getWritePointer(0, buffer->getNumSamples() - size), incomingBuffer.getReadPointer(0, 0), size);
+            hasNewAudio = true;
         }
     }
+    if (!hasNewAudio) return false;     // nothing arrived (transport stopped, or silence), nothing to compute
+    FFTGen->produceFFTData(*buffer, negInfinity);     // only the most recent path is drawn anyway
     const auto fftBounds = getAnalysisArea().toFloat();
     const int fftSize = FFTGen->getFFTSize();
     const float binWidth = audioProcessor.getSampleRate() / (double)fftSize;
 
     while (FFTGen->getNumAvailableFFTDataBlocks() > 0) {    // generate paths from FFT data
-        std::vector<float> fftData;
-        if (FFTGen->getFFTData(fftData)) {
-            pathProducer->generatePath(fftData, fftBounds, fftSize, binWidth, negInfinity, closedPath);
+        if (!FFTGen->getFFTData(fftFrame)) continue;
+        if (viewMode == ModeSpectrogram) {
+            if (isSpectrogramSource) writeSpectrogramColumn(fftFrame, fftSize);
+            continue;
         }
+        applyViewMode(fftFrame, *displayCurve);
+        pathProducer->generatePath(displayCurve->levels, fftBounds, fftSize, binWidth, negInfinity, closedPath);
     }
 
     while (pathProducer->getNumPathsAvailable() > 0) {    // pull paths as long as there are any, draw the most recent one
         pathProducer->getPath(*path);
     }
+    return true;
+}
+
+void DisplayComponent::applyViewMode(const std::vector<float>& fftData, DisplayCurve& curve) const {
+    const int numBins = (int)fftData.size() / 2;     // the upper half is the FFT's workspace
+    auto& levels = curve.levels;
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const float elapsedSeconds = (float)((now - curve.lastUpdateMs) * 0.001);
+    curve.lastUpdateMs = now;
+    if (viewMode == ModeInstant || (int)levels.size() != numBins) {
+        levels.assign(fftData.begin(), fftData.begin() + numBins);
+        return;
+    }
+    if (viewMode == ModeAverage) {
+        const float weight = 1.f - (float)std::exp(-elapsedSeconds / AverageSeconds);    // of the newest frame
+        juce::FloatVectorOperations::multiply(levels.data(), 1.f - weight, numBins);
+        juce::FloatVectorOperations::addWithMultiply(levels.data(), fftData.data(), weight, numBins);
+    } else {
+        juce::FloatVectorOperations::add(levels.data(), -PeakFallDecibelsPerSecond * elapsedSeconds, numBins);
+        juce::FloatVectorOperations::max(levels.data(), levels.data(), fftData.data(), numBins);
+    }
+}
+
+void DisplayComponent::writeSpectrogramColumn(const std::vector<float>& fftData, int fftSize) {
+    const int height = spectrogram.getHeight();
+    const int numBins = fftSize / 2;
+    if (audioProcessor.getSampleRate() <= 0.0) return;
+    if (spectrogramFFTSize != fftSize) {
+        spectrogramFFTSize = fftSize;
+        spectrogramRowEdges.resize((size_t)height + 1);
+        const double binWidth = audioProcessor.getSampleRate() / (double)fftSize;
+        for (int edge = 0; edge <= height; edge++) {
+            const double frequency = juce::mapToLog10(1.0 - ((double)edge / height), 20.0, 20000.0);
+            spectrogramRowEdges[edge] = juce::jlimit(0, numBins - 1, (int)std::round(frequency / binWidth));
+        }
+    }
+
+    // the loudest bin of each row, so narrow peaks at high frequencies are not skipped
+    juce::Image::BitmapData pixels(spectrogram, spectrogramColumn, 0, 1, height, juce::Image::BitmapData::writeOnly);
+    const int lastColour = (int)spectrogramColours.size() - 1;
+    for (int row = 0; row < height; row++) {
+        const int lowest = spectrogramRowEdges[row + 1];
+        const int highest = std::max(lowest, spectrogramRowEdges[row]);
+        const float level = *std::max_element(fftData.begin() + lowest, fftData.begin() + highest + 1);
+        const int index = juce::jlimit(0, lastColour, (int)juce::jmap(level, AnalyzerFloor, 0.f, 0.f, (float)lastColour));
+        pixels.setPixelColour(0, row, spectrogramColours[index]);
+    }
+    spectrogramColumn = (spectrogramColumn + 1) % spectrogram.getWidth();
+}
+
+void DisplayComponent::mouseDown(const juce::MouseEvent&) {
+    auto* parameter = audioProcessor.apvts.getParameter("DisplayMode");
+    const int nextMode = (viewMode + 1) % AnalyzerModeOptions.size();
+    parameter->beginChangeGesture();
+    parameter->setValueNotifyingHost(parameter->convertTo0to1((float)nextMode));
+    parameter->endChangeGesture();
 }
 
 void DisplayComponent::timerCallback() {
-    generatePathFromIncomingAudio(leftPreFifo, &preBuffer, &preFFTDataGenerator, &prePathProducer, &preFFTPath, false);
-    generatePathFromIncomingAudio(leftPostFifo, &postBuffer, &postFFTDataGenerator, &postPathProducer, &postFFTPath, false);
+    // only what changed is repainted; without new audio or parameter changes nothing is computed or drawn at all
+    const auto analysisArea = getAnalysisArea();
+    juce::Rectangle<float> dirtyArea;
+    auto markDirty = [&dirtyArea](juce::Rectangle<float> area) { dirtyArea = dirtyArea.getUnion(area); };
+    auto getPathArea = [analysisArea](const juce::Path& path) {
+        return path.getBounds().translated((float)analysisArea.getX(), (float)analysisArea.getY()).expanded(2.f);    // stroke width
+    };
+
+    const auto newViewMode = static_cast<AnalyzerMode>(audioProcessor.apvts.getRawParameterValue("DisplayMode")->load());
+    if (newViewMode != viewMode || isEnabled != wasEnabled) {   // averages and holds start over
+        viewMode = newViewMode;
+        wasEnabled = isEnabled;
+        preDisplayCurve.levels.clear();
+        postDisplayCurve.levels.clear();
+        markDirty(getRenderArea().toFloat());
+    }
+
+    // economy: FFTs of all instances are staggered over the scheduler's ticks (one timer interval long), audio keeps
+    // queueing in the FIFOs meanwhile
+    const bool isEconomy = audioProcessor.apvts.getRawParameterValue("Economy")->load() > 0.5f;
+    if (isEnabled && (!isEconomy || loadScheduler->isTurn(audioProcessor.getSchedulerSlot(), 1.0 / juce::jmax(1, getTimerHz()), lastSchedulerTurn))) {
+        const auto previousPreArea = getPathArea(preFFTPath), previousPostArea = getPathArea(postFFTPath);
+        if (viewMode != ModeSpectrogram    // the spectrogram only shows the post curve, the pre FIFO isn't fed meanwhile
+            && generatePathFromIncomingAudio(leftPreFifo, &preBuffer, &preFFTDataGenerator, &prePathProducer, &preFFTPath, &preDisplayCurve, false, false)) {
+            markDirty(previousPreArea.getUnion(getPathArea(preFFTPath)));
+        }
+        if (generatePathFromIncomingAudio(leftPostFifo, &postBuffer, &postFFTDataGenerator, &postPathProducer, &postFFTPath, &postDisplayCurve, false, true)) {
+            markDirty(viewMode == ModeSpectrogram ? analysisArea.toFloat() : previousPostArea.getUnion(getPathArea(postFFTPath)));
+        }
+    }
     if (parametersChanged.compareAndSetBool(false, true)) {
+        const auto previousCurveArea = filterResponseCurve.getBounds().expanded(2.f);
         updateSettings();
+        markDirty(previousCurveArea.getUnion(filterResponseCurve.getBounds().expanded(2.f)));
     }
-    repaint(); // repaint not only on param changes, because of paths
+    if (!dirtyArea.isEmpty()) repaint(dirtyArea.getSmallestIntegerContainer());
 }
@@ -26,6 +26,7 @@ struct DisplayComponent : juce::Component, juce::AudioProcessorParameter::Listen
 
     void paint(juce::Graphics& g) override;
     void resized() override;
+    void mouseDown(const juce::MouseEvent& event) override;     // cycles through the view modes
 
     bool isEnabled = true;
     bool isHQ = true;
@@ -35,21 +36,52 @@ private:
 
     void updateSettings();
     MonoChain monoChain;
+    juce::Path filterResponseCurve;     // rebuilt on parameter changes and resizes, not per paint
+    void updateResponseCurve();
+    bool wasEnabled = true;
 
     juce::Image background;
     juce::Rectangle<int> getRenderArea();
     juce::Rectangle<int> getAnalysisArea();
     int gridFontHeight = 8;
 
-    void generatePathFromIncomingAudio(SingleChannelSampleFifo<GnomeDistortAudioProcessor::BlockType>* fifo,
+    static constexpr float AnalyzerFloor = -48.f;
+    struct DisplayCurve {       // spectrum as shown in the current view mode
+        std::vector<float> levels;
+        double lastUpdateMs = 0.0;
+    };
+    // false if no new audio arrived
+    bool generatePathFromIncomingAudio(SingleChannelSampleFifo<GnomeDistortAudioProcessor::BlockType>* fifo,
                                        juce::AudioBuffer<float>* buffer,
                                        FFTDataGenerator<std::vector<float>>* FFTGen,
                                        AnalyzerPathGenerator<juce::Path>* pathProducer,
-                                       juce::Path* path, bool closedPath);
+                                       juce::Path* path, DisplayCurve* displayCurve, bool closedPath, bool isSpectrogramSource);
     SingleChannelSampleFifo<GnomeDistortAudioProcessor::BlockType>* leftPreFifo;
     SingleChannelSampleFifo<GnomeDistortAudioProcessor::BlockType>* leftPostFifo;
     juce::AudioBuffer<float> preBuffer, postBuffer;
     FFTDataGenerator<std::vector<float>> preFFTDataGenerator, postFFTDataGenerator;
     AnalyzerPathGenerator<juce::Path> prePathProducer, postPathProducer;
     juce::Path preFFTPath, postFFTPath;
+    // exchanged with the fifos' slots on every pull, so they stay allocated between frames
+    juce::AudioBuffer<float> incomingBuffer;
+    std::vector<float> fftFrame;
+
+    // view modes; averaging and peak hold work on the spectrum in dB, per curve, over the time between its frames
+    // (which depends on the timer rate and, in economy mode, on the scheduler)
+    static constexpr double AverageSeconds = 0.075;          // time constant
+    static constexpr float PeakFallDecibelsPerSecond = 12.f;
+    AnalyzerMode viewMode = ModeInstant;
+    DisplayCurve preDisplayCurve, postDisplayCurve;
+    void applyViewMode(const std::vector<float>& fftData, DisplayCurve& curve) const;
+
+    juce::SharedResourcePointer<LoadScheduler> loadScheduler;   // economy: FFTs only on this editor's turn
+    juce::int64 lastSchedulerTurn = LoadScheduler::NoTurn;
+
+    // spectrogram: a ring of columns, one written per FFT frame and never redrawn; spectrogramColumn is the oldest
+    juce::Image spectrogram;
+    int spectrogramColumn = 0;
+    int spectrogramFFTSize = 0;
+    std::vector<int> spectrogramRowEdges;   // FFT bin at each row boundary, top (20 kHz) first, log frequency like the grid
+    std::array<juce::Colour, 256> spectrogramColours;   // from AnalyzerFloor to 0 dB
+    void writeSpectrogramColumn(const std::vector<float>& fftData, int fftSize);
 };
@@ -9,6 +9,7 @@
 */
 
 #include "DisplayGraph.h"
+#include "../DSP/WaveShaperKernels.h"
 
 DisplayGraph::DisplayGraph(GnomeDistortAudioProcessor& p) : audioProcessor(p) {
     for (auto param : audioProcessor.getParameters()) {
@@ -16,8 +17,11 @@ DisplayGraph::DisplayGraph(GnomeDistortAudioProcessor& p) : audioProcessor(p) {
         if (param->getName(64) == "WaveShapeFunction") { param->addListener(this); continue; }
     }
     parameterValueChanged(0, 0.f);
+    audioProcessor.transferScope.setActive(true);
+    startTimerHz(ScopeRefreshHz);
 }
 DisplayGraph::~DisplayGraph() {
+    audioProcessor.transferScope.setActive(false);
     for (auto param : audioProcessor.getParameters()) {
         param->removeListener(this);
     }
@@ -28,6 +32,7 @@ void DisplayGraph::resized() {
     auto bounds = getLocalBounds();
     auto renderArea = getRenderArea();
     background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
+    scope = Image(Image::PixelFormat::ARGB, jmax(1, renderArea.getWidth()), jmax(1, renderArea.getHeight()), true);
     Graphics g(background);
     g.setColour(COLOR_BG_VERYDARK);
     g.fillAll();
@@ -48,23 +53,42 @@ void DisplayGraph::paint(juce::Graphics& g) {
     int bottom = renderArea.getBottom();
     auto mapX = [left, right](int x) {return jmap((float)x, (float)left, (float)right, -1.f, 1.f); };
     auto mapY = [top, bottom](float y) {return jmap(y, -1.f, 1.f, (float)bottom, (float)top); };
+    if (framesWithoutPoints < ScopeFadeFrames) g.drawImageAt(scope, left, top);
     g.setColour(COLOR_KNOB);
     Path graph;
-    graph.startNewSubPath(renderArea.getX(), mapY(waveshaperFunction(-1)));
+    graph.startNewSubPath(renderArea.getX(), mapY(Kernels::shapeSample(waveShapeFunction, -1, waveShapeAmount)));
     for (int x = left + 1; x < right; x++) {
-        graph.lineTo(x, mapY(waveshaperFunction(mapX(x))));
+        graph.lineTo(x, mapY(Kernels::shapeSample(waveShapeFunction, mapX(x), waveShapeAmount)));
     }
     g.strokePath(graph, PathStrokeType(2));   // draw path
 }
 
+void DisplayGraph::timerCallback() {
+    const int numPoints = audioProcessor.transferScope.pull(scopePoints.data(), (int)scopePoints.size());
+    if (numPoints == 0 && framesWithoutPoints >= ScopeFadeFrames) return;   // faded out, nothing to repaint
+    framesWithoutPoints = numPoints > 0 ? 0 : framesWithoutPoints + 1;
+
+    scope.multiplyAllAlphas(ScopeDecay);
+    if (numPoints > 0) {
+        const int width = scope.getWidth(), height = scope.getHeight();
+        juce::Image::BitmapData pixels(scope, juce::Image::BitmapData::readWrite);
+        for (int i = 0; i < numPoints; i++) {
+            const int x = juce::roundToInt(juce::jmap(scopePoints[i].input, -1.f, 1.f, 0.f, (float)(width - 1)));
+            const int y = juce::roundToInt(juce::jmap(scopePoints[i].output, -1.f, 1.f, (float)(height - 1), 0.f));
+            if (!juce::isPositiveAndBelow(x, width) || !juce::isPositiveAndBelow(y, height)) continue;    // off the plotted range
+            const float alpha = juce::jmin(1.f, pixels.getPixelColour(x, y).getFloatAlpha() + ScopePointIntensity);
+            pixels.setPixelColour(x, y, juce::Colours::lightgrey.withAlpha(alpha));
+        }
+    }
+    repaint(getRenderArea());
+}
+
 void DisplayGraph::parameterValueChanged(int parameterIndex, float newValue) {
     ChainSettings chainSettings = getChainSettings(audioProcessor.apvts);
-    float amount = chainSettings.WaveShapeAmount;
-    int func = chainSettings.WaveShapeFunction;
-    if (parameterIndex == TreeParameter::PosWaveShapeAmount) amount = newValue;
+    int func = chainSettings.WaveShapeFunction[0];
     if (parameterIndex == TreeParameter::PosWaveShapeFunction) func = juce::jmap(newValue, 0.f, (float)WaveShaperOptions.size() - 1);
-    WaveShaperFunction waveShapeFunction = static_cast<WaveShaperFunction>(func);
-    waveshaperFunction = getWaveshaperFunction(waveShapeFunction, chainSettings.WaveShapeAmount);
+    waveShapeFunction = func;
+    waveShapeAmount = chainSettings.WaveShapeAmount[0];     // newValue is normalised, the raw value is already updated
     juce::MessageManagerLock mml(juce::Thread::getCurrentThread());
     if (mml.lockWasGained()) {
         repaint();
@@ -15,7 +15,7 @@
 #include "../Helpers/FFTDataGenerator.h"
 #include "GlobalConsts.h"
 
-struct DisplayGraph : juce::Component, juce::AudioProcessorParameter::Listener {
+struct DisplayGraph : juce::Component, juce::AudioProcessorParameter::Listener, juce::Timer {
     DisplayGraph(GnomeDistortAudioProcessor&);
     ~DisplayGraph();
 
@@ -24,11 +24,22 @@ struct DisplayGraph : juce::Component, juce::AudioProcessorParameter::Listener {
 
     void paint(juce::Graphics& g) override;
     void resized() override;
+    void timerCallback() override;
 
 private:
     GnomeDistortAudioProcessor& audioProcessor;
     juce::Image background;
-    std::function<float(float)> waveshaperFunction;
+    int waveShapeFunction = WaveShaperFunction::HardClip;    // drawn with Kernels::shapeSample
+    float waveShapeAmount = 0.f;
+
+    // the actual signal on the curve: points of TransferScope accumulate in a bitmap which fades out every frame
+    static constexpr int ScopeRefreshHz = 30;
+    static constexpr float ScopeDecay = 0.85f;          // alpha kept per frame
+    static constexpr float ScopePointIntensity = 0.25f;  // alpha added per point
+    static constexpr int ScopeFadeFrames = 35;          // 0.85^35 < 1/255
+    juce::Image scope;
+    std::vector<TransferScope::Point> scopePoints = std::vector<TransferScope::Point>(TransferScope::Capacity);
+    int framesWithoutPoints = ScopeFadeFrames;
 
     juce::Rectangle<int> getRenderArea();
 };
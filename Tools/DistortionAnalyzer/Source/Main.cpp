@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 21 Oct 2026 12:14:06am
+    Author:  traxx
+
+    Offline analysis of the distortion section: drives DistortionEngine with a stepped sine sweep at several sample
+    rates, for every WaveShaperFunction and a range of amounts, and writes THD+N, aliasing-to-signal ratio and
+    DC offset as CSV. Spectra come from FFTDataGenerator, the same code path as the analyzer, at a large order.
+
+    Usage: DistortionAnalyzer [--rates=44100,48000,96000] [--amounts=0,0.5,0.99] [--frequencies=100,1000,5000]
+                              [--level=0] [--pregain=0] [--bias=0] [--order=16] [--fast] [--dcblock]
+                              [--output=file.csv]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/DSP/DistortionEngine.h"
+#include "../../../Source/Helpers/FFTDataGenerator.h"
+#include "../../Shared/AudioFingerprint.h"
+
+static constexpr float NegativeInfinity = -300.f;   // far below anything a float render produces
+static constexpr float Floor = -200.f;              // dB reported for a ratio of 0
+static constexpr int LobeBins = 4;                  // main lobe of the Blackman-Harris window, either side
+static constexpr int MinFundamentalBin = 4 * LobeBins;
+static constexpr int BlockSize = 512;
+
+struct Measurement {
+    double frequency;
+    float thdPlusNoise, aliasing, dcOffset;
+};
+
+static juce::Array<double> parseList(const juce::ArgumentList& args, const juce::String& option, const juce::String& defaults) {
+    const auto text = args.containsOption(option) ? args.getValueForOption(option) : defaults;
+    juce::Array<double> values;
+    for (const auto& token : juce::StringArray::fromTokens(text, ",", ""))
+        if (token.trim().isNotEmpty()) values.add(token.trim().getDoubleValue());
+    return values;
+}
+
+static float getOptionValue(const juce::ArgumentList& args, const juce::String& option, float defaultValue) {
+    return args.containsOption(option) ? args.getValueForOption(option).getFloatValue() : defaultValue;
+}
+
+// nearest odd bin: coprime with the (power of two) FFT size, so no harmonic, folded or not, lands on another one's bin
+static int getFundamentalBin(double frequency, double sampleRate, int fftSize) {
+    int bin = std::max(MinFundamentalBin, (int)std::round(frequency * fftSize / sampleRate));
+    if (bin % 2 == 0) bin++;
+    return bin;
+}
+
+// spectrum in dB as produced by FFTDataGenerator; everything but DC and the fundamental is THD+N, everything of that
+// off the harmonic series is aliasing (the waveshaper is memoryless, so it can't produce anything else)
+static Measurement analyse(const std::vector<float>& spectrum, const float* samples, int fftSize, int fundamentalBin, double binWidth) {
+    const int numBins = fftSize / 2;
+    double fundamental = 0.0, distortion = 0.0, aliasing = 0.0;
+    for (int bin = LobeBins + 1; bin < numBins; bin++) {
+        const double power = std::pow(10.0, spectrum[bin] / 10.0);
+        const int distance = bin % fundamentalBin;
+        const bool isHarmonic = std::min(distance, fundamentalBin - distance) <= LobeBins;
+        if (std::abs(bin - fundamentalBin) <= LobeBins) fundamental += power;
+        else {
+            distortion += power;
+            if (!isHarmonic) aliasing += power;
+        }
+    }
+
+    auto ratio = [fundamental](double power) {
+        return fundamental > 0.0 ? juce::Decibels::gainToDecibels((float)std::sqrt(power / fundamental), Floor) : Floor;
+    };
+    double sum = 0.0;
+    for (int i = 0; i < fftSize; i++) sum += samples[i];
+    return { fundamentalBin * binWidth, ratio(distortion), ratio(aliasing), (float)(sum / fftSize) };
+}
+
+int main(int argc, char* argv[]) {
+    const juce::ArgumentList args(argc, argv);
+    const auto sampleRates = parseList(args, "--rates", "44100,48000,88200,96000");
+    const auto amounts = parseList(args, "--amounts", "0,0.25,0.5,0.75,0.99");
+    const auto frequencies = parseList(args, "--frequencies", "100,1000,5000,10000");
+    const float level = juce::Decibels::decibelsToGain(getOptionValue(args, "--level", 0.f));
+    const float preGain = getOptionValue(args, "--pregain", 0.f);
+    const float bias = getOptionValue(args, "--bias", 0.f);
+    const int order = juce::jlimit((int)FFTOrder::order2048, (int)FFTOrder::order65536, (int)getOptionValue(args, "--order", FFTOrder::order65536));
+    const bool withFastMath = args.containsOption("--fast");
+    const bool withDCBlocker = args.containsOption("--dcblock");
+
+    std::unique_ptr<juce::OutputStream> output;
+    if (args.containsOption("--output")) {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+        file.deleteFile();
+        output = std::make_unique<juce::FileOutputStream>(file);
+        if (static_cast<juce::FileOutputStream*>(output.get())->failedToOpen()) {
+            std::cerr << "Can't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    } else output = std::make_unique<juce::MemoryOutputStream>();
+
+    FFTDataGenerator<std::vector<float>> fftDataGenerator;
+    fftDataGenerator.changeOrder(static_cast<FFTOrder>(order));
+    const int fftSize = fftDataGenerator.getFFTSize();
+    const int numSamples = fftSize + BlockSize;     // the first block is left out of the analysis
+    std::vector<float> spectrum;
+
+    *output << "sample_rate,function,amount,math,frequency,thd_n_db,aliasing_db,dc_offset\n";
+    for (double sampleRate : sampleRates) {
+        DistortionEngine distortion;
+        distortion.prepare({ sampleRate, (juce::uint32)BlockSize, 1 });
+        distortion.setPreGain(preGain);
+        distortion.setBias(bias);
+        distortion.setNumBands(1);
+        distortion.setDCBlocker(withDCBlocker);
+        const double binWidth = sampleRate / fftSize;
+
+        for (double frequency : frequencies) {
+            const int fundamentalBin = getFundamentalBin(frequency, sampleRate, fftSize);
+            if (fundamentalBin >= (fftSize / 2) - LobeBins) continue;
+            juce::AudioBuffer<float> input(1, numSamples);
+            TestSignals::sine(input, sampleRate, fundamentalBin * binWidth, level);
+            juce::AudioBuffer<float> rendered(1, numSamples);
+
+            for (int function = 0; function < WaveShaperOptions.size(); function++) {
+                for (double amount : amounts) {
+                    for (int pass = 0; pass < (withFastMath ? 2 : 1); pass++) {
+                        const bool isFast = pass > 0;
+                        distortion.setBandWaveShaper(0, static_cast<WaveShaperFunction>(function), (float)amount);
+                        distortion.setUseFastMath(isFast);
+                        distortion.reset();
+                        rendered.makeCopyOf(input, true);
+                        juce::dsp::AudioBlock<float> block(rendered);
+                        for (int start = 0; start < numSamples; start += BlockSize) {
+                            auto subBlock = block.getSubBlock((size_t)start, (size_t)std::min(BlockSize, numSamples - start));
+                            distortion.process(juce::dsp::ProcessContextReplacing<float>(subBlock));
+                        }
+
+                        float* analysed = rendered.getWritePointer(0, BlockSize);
+                        const juce::AudioBuffer<float> segment(&analysed, 1, fftSize);
+                        fftDataGenerator.produceFFTData(segment, NegativeInfinity);
+                        while (fftDataGenerator.getNumAvailableFFTDataBlocks() > 0) fftDataGenerator.getFFTData(spectrum);
+                        const auto result = analyse(spectrum, analysed, fftSize, fundamentalBin, binWidth);
+
+                        *output << juce::String(sampleRate, 0) << "," << WaveShaperOptions[function] << "," << juce::String(amount, 3) << ","
+                                << (isFast ? "fast" : "exact") << "," << juce::String(result.frequency, 2) << ","
+                                << juce::String(result.thdPlusNoise, 2) << "," << juce::String(result.aliasing, 2) << ","
+                                << juce::String(result.dcOffset, 6) << "\n";
+                    }
+                }
+            }
+            std::cerr << juce::String(sampleRate, 0) << " Hz, " << juce::String(frequency, 0) << " Hz done" << std::endl;
+        }
+    }
+
+    if (auto* memory = dynamic_cast<juce::MemoryOutputStream*>(output.get())) std::cout << memory->toString();
+    return 0;
+}
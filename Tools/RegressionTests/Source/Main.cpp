@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 21 Oct 2026 4:12:37am
+    Author:  traxx
+
+    Regression test of the plugin's sound: renders deterministic signals through GnomeDistortAudioProcessor (no
+    editor) for every WaveShaperFunction x cut slope x parameter corner and compares the fingerprints with the golden
+    ones in Goldens/fingerprints.json. Before that, the "kernels" case compares the waveshaper kernels with the
+    closures they replaced, which has to be exact (the Xcode exporter turns off FMA contraction for it), and the
+    "fastmath" case FastMath's sin/cos over their whole range.
+    Exits with 1 if a case differs by more than the tolerance or has no golden.
+    The checked in goldens are the sound of the original processor (commit 3ebc661). Cases a change alters on purpose
+    are re-written with --update --filter=<case> once reviewed, and checked in with that change; --update without a
+    filter would accept every difference at once.
+    Built with GNOMEDISTORT_ISOLATED_PRESETS, so the processors get an empty preset bank instead of the user's.
+
+    Usage: RegressionTests [--goldens=Goldens/fingerprints.json] [--tolerance=0.1] [--filter=text] [--update]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/DSP/WaveShaperKernels.h"
+#include "../../Shared/AudioFingerprint.h"
+#include "../../Shared/ReferenceWaveShapers.h"
+
+static constexpr double SampleRate = 48000.0;
+static constexpr int BlockSize = 512;
+static constexpr int NumSamples = 1 << 16;      // one spectrum of the largest order the fingerprint takes
+static constexpr double SineFrequency = 1000.0;
+static constexpr float SignalGain = 0.5f;       // -6 dBFS
+static constexpr double FastMathTolerance = 5e-7;   // absolute, documented in FastMath.h
+
+// parameter corners on top of the defaults, as normalised values
+struct Corner {
+    const char* name;
+    std::vector<std::pair<const char*, float>> values;
+};
+static const Corner Corners[] = {
+    { "default", {} },
+    { "low", { { "PreGain", 0.f }, { "Bias", 0.f }, { "WaveShapeAmount", 0.f }, { "PostGain", 0.f } } },
+    { "high", { { "PreGain", 1.f }, { "Bias", 1.f }, { "WaveShapeAmount", 1.f }, { "PostGain", 1.f } } },
+    { "filters", { { "LoCutFreq", 0.3f }, { "HiCutFreq", 0.7f }, { "PeakGain", 1.f }, { "PeakQ", 1.f } } },
+    { "mix", { { "WaveShapeAmount", 0.5f }, { "DryWet", 0.5f } } }
+};
+
+struct Signal {
+    const char* name;
+    double fundamental;     // for THD, 0 if the signal has none
+    std::function<void(juce::AudioBuffer<float>&)> generate;
+};
+static const Signal Signals[] = {
+    { "sine", SineFrequency, [](juce::AudioBuffer<float>& buffer) { TestSignals::sine(buffer, SampleRate, SineFrequency, SignalGain); } },
+    { "sweep", 0.0, [](juce::AudioBuffer<float>& buffer) { TestSignals::sweep(buffer, SampleRate, 20.0, 20000.0, SignalGain); } },
+    { "noise", 0.0, [](juce::AudioBuffer<float>& buffer) { TestSignals::noise(buffer, SignalGain, 41); } },
+    { "impulse", 0.0, [](juce::AudioBuffer<float>& buffer) { TestSignals::impulse(buffer, 1.f); } }
+};
+
+// the kernels with ExactMath against the closures they replaced, bit for bit: single samples and both block loop
+// sources, over a dense input grid plus a few ULPs around every Rash step; returns the number of mismatches
+static int checkKernels() {
+    std::vector<float> inputs;
+    for (int i = -3 * 4096; i <= 3 * 4096; i++) inputs.push_back(i / 4096.f);
+    for (const float step : Kernels::Rash::Steps) {
+        float below = step, above = step;
+        inputs.push_back(step);
+        for (int ulp = 0; ulp < 3; ulp++) {
+            below = std::nextafter(below, -2.f);
+            above = std::nextafter(above, 2.f);
+            inputs.push_back(below);
+            inputs.push_back(above);
+        }
+    }
+    inputs.push_back(std::numeric_limits<float>::quiet_NaN());
+    const int numInputs = (int)inputs.size();
+    std::vector<float> single((size_t)numInputs), constant((size_t)numInputs), perSample((size_t)numInputs);
+    std::vector<float> amounts((size_t)numInputs), ones((size_t)numInputs, 1.f);
+    auto isSame = [](float a, float b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+
+    int numMismatches = 0;
+    for (int function = 0; function < WaveShaperOptions.size(); function++) {
+        for (int step = 0; step < 100; step++) {
+            const float amount = step / 100.f;
+            const auto reference = getReferenceFunction(static_cast<WaveShaperFunction>(function), amount);
+            std::fill(amounts.begin(), amounts.end(), amount);
+            for (int i = 0; i < numInputs; i++) single[i] = Kernels::shapeSample(function, inputs[i], amount);
+            Kernels::getShapeBlock<false, ExactMath, Kernels::Constant>(function)(inputs.data(), constant.data(), numInputs, { amount }, { 1.f }, 0.f, 1.f, nullptr);
+            Kernels::getShapeBlock<false, ExactMath, Kernels::PerSample>(function)(inputs.data(), perSample.data(), numInputs, { amounts.data() }, { ones.data() }, 0.f, 1.f, nullptr);
+            for (int i = 0; i < numInputs; i++) {
+                const float expected = reference(inputs[i]);
+                if (isSame(single[i], expected) && isSame(constant[i], expected) && isSame(perSample[i], expected)) continue;
+                if (numMismatches++ < 10) {
+                    std::cout << "FAIL kernels/" << WaveShaperOptions[function] << " amount " << amount << " x " << juce::String(inputs[i], 9)
+                              << ": " << juce::String(expected, 9) << " expected, " << juce::String(single[i], 9) << " / "
+                              << juce::String(constant[i], 9) << " / " << juce::String(perSample[i], 9) << std::endl;
+                }
+            }
+        }
+    }
+    return numMismatches;
+}
+
+// FastMath::sin/cos against double precision over their whole exact range, which covers the curves' largest arguments;
+// returns the largest absolute error
+static double checkFastMath() {
+    juce::Random random(32);
+    double maxError = 0.0;
+    auto check = [&maxError](float x) {
+        maxError = juce::jmax(maxError, std::abs(FastMath::sin(x) - std::sin((double)x)), std::abs(FastMath::cos(x) - std::cos((double)x)));
+    };
+    for (int i = 0; i < 1000000; i++) check(((random.nextFloat() * 2.f) - 1.f) * FastMath::MaxArgument);
+    for (int i = 0; i < 1000000; i++) check(i * 1e-5f);
+    for (int k = 1; (float)(k * juce::MathConstants<double>::halfPi) < FastMath::MaxArgument; k += 97) {   // zeros and extremes
+        float x = (float)(k * juce::MathConstants<double>::halfPi);
+        for (int ulp = 0; ulp < 4; ulp++, x = std::nextafter(x, 0.f)) check(x);
+    }
+    return maxError;
+}
+
+static void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float normalisedValue) {
+    auto* parameter = apvts.getParameter(id);
+    jassert(parameter != nullptr);
+    parameter->setValueNotifyingHost(normalisedValue);
+}
+
+int main(int argc, char* argv[]) {
+    const juce::ArgumentList args(argc, argv);
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;    // the processor posts async updates
+    const auto goldensFile = juce::File::getCurrentWorkingDirectory().getChildFile(
+        args.containsOption("--goldens") ? args.getValueForOption("--goldens") : "Goldens/fingerprints.json");
+    const float tolerance = args.containsOption("--tolerance") ? args.getValueForOption("--tolerance").getFloatValue() : 0.1f;
+    const auto filter = args.getValueForOption("--filter");
+    const bool isUpdate = args.containsOption("--update");
+
+    auto goldens = juce::JSON::parse(goldensFile);
+    if (!goldens.isObject()) {
+        if (!isUpdate) {
+            std::cerr << "No golden fingerprints in " << goldensFile.getFullPathName() << ", generate them with --update" << std::endl;
+            return 1;
+        }
+        goldens = juce::var(new juce::DynamicObject());
+    }
+
+    const auto slopes = GnomeDistortAudioProcessor::getSlopeOptions();
+    juce::AudioBuffer<float> input(2, NumSamples);
+    int numCases = 0, numFailed = 0;
+    if (!isUpdate && (filter.isEmpty() || juce::String("kernels").containsIgnoreCase(filter))) {
+        numCases++;
+        const int numMismatches = checkKernels();
+        if (numMismatches > 0) {
+            numFailed++;
+            std::cout << "FAIL kernels: " << numMismatches << " mismatches" << std::endl;
+        }
+    }
+    if (!isUpdate && (filter.isEmpty() || juce::String("fastmath").containsIgnoreCase(filter))) {
+        numCases++;
+        const double maxError = checkFastMath();
+        if (maxError > FastMathTolerance) {
+            numFailed++;
+            std::cout << "FAIL fastmath: max. error " << maxError << std::endl;
+        }
+    }
+    for (int function = 0; function < WaveShaperOptions.size(); function++) {
+        for (int slope = 0; slope < slopes.size(); slope++) {
+            for (const auto& corner : Corners) {
+                const juce::String setting = WaveShaperOptions[function] + "/" + slopes[slope] + "/" + corner.name;
+                if (filter.isNotEmpty() && !setting.containsIgnoreCase(filter)) continue;
+
+                // a fresh instance per setting, so nothing carries over from the previous one
+                GnomeDistortAudioProcessor processor;
+                auto& apvts = processor.apvts;
+                setParameter(apvts, "WaveShapeFunction", apvts.getParameter("WaveShapeFunction")->convertTo0to1((float)function));
+                setParameter(apvts, "LoCutSlope", apvts.getParameter("LoCutSlope")->convertTo0to1((float)slope));
+                setParameter(apvts, "HiCutSlope", apvts.getParameter("HiCutSlope")->convertTo0to1((float)slope));
+                for (const auto& [id, value] : corner.values) setParameter(apvts, id, value);
+
+                for (const auto& signal : Signals) {
+                    const juce::String name = setting + "/" + signal.name;
+                    signal.generate(input);
+                    const auto output = renderThroughProcessor(processor, input, SampleRate, BlockSize);
+                    const auto fingerprint = AudioFingerprint::measure(output, SampleRate, signal.fundamental);
+                    numCases++;
+
+                    if (isUpdate) {
+                        goldens.getDynamicObject()->setProperty(name, fingerprint.toVar());
+                        continue;
+                    }
+                    const auto golden = goldens.getProperty(name, juce::var());
+                    juce::StringArray report;
+                    if (golden.isVoid()) report.add("no golden fingerprint");
+                    else fingerprint.matches(AudioFingerprint::fromVar(golden), tolerance, &report);
+                    if (report.isEmpty()) continue;
+                    numFailed++;
+                    std::cout << "FAIL " << name << std::endl;
+                    for (const auto& line : report) std::cout << "    " << line << std::endl;
+                }
+            }
+        }
+    }
+
+    if (isUpdate) {
+        if (!goldensFile.getParentDirectory().createDirectory() || !goldensFile.replaceWithText(juce::JSON::toString(goldens))) {
+            std::cerr << "Can't write " << goldensFile.getFullPathName() << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << numCases << " golden fingerprints to " << goldensFile.getFullPathName() << std::endl;
+        return 0;
+    }
+    std::cout << (numCases - numFailed) << " of " << numCases << " cases match within " << tolerance << " dB" << std::endl;
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    AudioFingerprint.h
+    Created: 20 Oct 2026 10:48:13pm
+    Author:  traxx
+
+    Deterministic test signals, offline rendering through a processor and a compact fingerprint of the result
+    (peak, RMS, RMS per octave band, THD of a sine response), to compare renders before and after an optimization.
+    Test code only, shared by the tools; the plugin doesn't build it
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/Helpers/FFTDataGenerator.h"
+
+namespace TestSignals {
+    inline void sine(juce::AudioBuffer<float>& buffer, double sampleRate, double frequency, float gain) {
+        for (int i = 0; i < buffer.getNumSamples(); i++) {
+            const float sample = gain * (float)std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate);
+            for (int channel = 0; channel < buffer.getNumChannels(); channel++) buffer.setSample(channel, i, sample);
+        }
+    }
+
+    // exponential sweep from startFrequency to endFrequency over the whole buffer
+    inline void sweep(juce::AudioBuffer<float>& buffer, double sampleRate, double startFrequency, double endFrequency, float gain) {
+        const double duration = buffer.getNumSamples() / sampleRate;
+        const double rate = std::log(endFrequency / startFrequency) / duration;
+        for (int i = 0; i < buffer.getNumSamples(); i++) {
+            const double phase = juce::MathConstants<double>::twoPi * startFrequency * (std::exp(rate * i / sampleRate) - 1.0) / rate;
+            const float sample = gain * (float)std::sin(phase);
+            for (int channel = 0; channel < buffer.getNumChannels(); channel++) buffer.setSample(channel, i, sample);
+        }
+    }
+
+    // white noise, the same for a given seed on every platform
+    inline void noise(juce::AudioBuffer<float>& buffer, float gain, juce::int64 seed) {
+        juce::Random random(seed);
+        for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+            for (int i = 0; i < buffer.getNumSamples(); i++) buffer.setSample(channel, i, gain * ((random.nextFloat() * 2.f) - 1.f));
+        }
+    }
+
+    inline void impulse(juce::AudioBuffer<float>& buffer, float gain) {
+        buffer.clear();
+        for (int channel = 0; channel < buffer.getNumChannels(); channel++) buffer.setSample(channel, 0, gain);
+    }
+}
+
+// renders input through an already configured processor (parameters set), offline and in blocks of blockSize
+inline juce::AudioBuffer<float> renderThroughProcessor(juce::AudioProcessor& processor, const juce::AudioBuffer<float>& input, double sampleRate, int blockSize) {
+    const int numChannels = input.getNumChannels();
+    processor.setNonRealtime(true);
+    processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> output(input);
+    juce::AudioBuffer<float> block(std::max(numChannels, processor.getTotalNumInputChannels()), blockSize);
+    juce::MidiBuffer midi;
+    for (int start = 0; start < input.getNumSamples(); start += blockSize) {
+        const int length = std::min(blockSize, input.getNumSamples() - start);
+        block.setSize(block.getNumChannels(), length, false, false, true);
+        block.clear();
+        for (int channel = 0; channel < numChannels; channel++) block.copyFrom(channel, 0, input, channel, start, length);
+        processor.processBlock(block, midi);
+        for (int channel = 0; channel < numChannels; channel++) output.copyFrom(channel, start, block, channel, 0, length);
+    }
+    processor.releaseResources();
+    return output;
+}
+
+struct AudioFingerprint {
+    static constexpr int NumBands = 10;         // octaves, the lowest from 31.25 to 62.5 Hz
+    static constexpr float LowestBand = 31.25f;
+    static constexpr float Floor = -200.f;      // dB of silence
+    // dB below the RMS (THD: below the fundamental) where the rounding noise of float processing and of the FFT
+    // engine takes over; values lower than that differ between platforms and compare as equal
+    static constexpr float Resolution = 110.f;
+
+    float peakDecibels = Floor, rmsDecibels = Floor;
+    std::array<float, NumBands> bandDecibels{};
+    float thdDecibels = Floor;                  // harmonics below Nyquist relative to the fundamental, if one was given
+
+    // first channel; the spectrum is taken over the end of the buffer, the largest power of two of samples up to
+    // 65536 (the largest FFTOrder), so longer renders resolve the low bands better
+    static AudioFingerprint measure(const juce::AudioBuffer<float>& buffer, double sampleRate, double fundamental = 0.0) {
+        AudioFingerprint result;
+        const int numSamples = buffer.getNumSamples();
+        const float* samples = buffer.getReadPointer(0);
+        result.peakDecibels = juce::Decibels::gainToDecibels(buffer.getMagnitude(0, 0, numSamples), Floor);
+        result.rmsDecibels = juce::Decibels::gainToDecibels(buffer.getRMSLevel(0, 0, numSamples), Floor);
+        result.bandDecibels.fill(Floor);
+
+        int order = FFTOrder::order2048;
+        while (order < FFTOrder::order65536 && (2 << order) <= numSamples) order++;
+        const int fftSize = 1 << order;
+        if (numSamples < fftSize) return result;
+
+        juce::SharedResourcePointer<FFTRegistry> registry;
+        const auto resources = registry->acquire(static_cast<FFTOrder>(order));
+        std::vector<float> fftData((size_t)fftSize * 2, 0.f);
+        const int offset = numSamples - fftSize;    // the end, past any onset
+        juce::FloatVectorOperations::multiply(fftData.data(), samples + offset, resources->window.data(), fftSize);
+        resources->fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        // one-sided power per bin, scaled so a band's sum is the mean square of the signal in that band
+        double windowPower = 0.0;
+        for (float w : resources->window) windowPower += (double)w * w;
+        std::vector<double> power((size_t)fftSize / 2);
+        for (int bin = 0; bin < fftSize / 2; bin++) power[bin] = 2.0 * fftData[bin] * fftData[bin] / (fftSize * windowPower);
+
+        const double binWidth = sampleRate / fftSize;
+        for (int band = 0; band < NumBands; band++) {
+            const int first = std::max(1, (int)std::ceil(LowestBand * (1 << band) / binWidth));
+            const int last = std::min(fftSize / 2, (int)std::ceil(LowestBand * (2 << band) / binWidth));
+            double sum = 0.0;
+            for (int bin = first; bin < last; bin++) sum += power[bin];
+            if (first < last) result.bandDecibels[band] = juce::Decibels::gainToDecibels((float)std::sqrt(sum), Floor);
+        }
+
+        if (fundamental > 0.0) {
+            constexpr int LobeBins = 4;     // main lobe of the Blackman-Harris window
+            auto harmonicPower = [&power, binWidth, fftSize](double frequency) {
+                const int centre = (int)std::round(frequency / binWidth);
+                double sum = 0.0;
+                for (int bin = std::max(1, centre - LobeBins); bin <= std::min(fftSize / 2 - 1, centre + LobeBins); bin++) sum += power[bin];
+                return sum;
+            };
+            const double fundamentalPower = harmonicPower(fundamental);
+            double distortionPower = 0.0;
+            for (int harmonic = 2; harmonic * fundamental < sampleRate / 2; harmonic++) distortionPower += harmonicPower(harmonic * fundamental);
+            if (fundamentalPower > 0.0) result.thdDecibels = juce::Decibels::gainToDecibels((float)std::sqrt(distortionPower / fundamentalPower), Floor);
+        }
+        return result;
+    }
+
+    // every value within toleranceDecibels of the golden one (down to Resolution); differences are listed in report, if given
+    bool matches(const AudioFingerprint& golden, float toleranceDecibels, juce::StringArray* report = nullptr) const {
+        bool isMatch = true;
+        auto compare = [&isMatch, report, toleranceDecibels](const juce::String& name, float value, float expected, float noiseFloor = Floor) {
+            if (std::abs(std::max(value, noiseFloor) - std::max(expected, noiseFloor)) <= toleranceDecibels) return;
+            isMatch = false;
+            if (report != nullptr) report->add(name + ": " + juce::String(value, 2) + " dB, expected " + juce::String(expected, 2) + " dB");
+        };
+        compare("peak", peakDecibels, golden.peakDecibels);
+        compare("rms", rmsDecibels, golden.rmsDecibels);
+        for (int band = 0; band < NumBands; band++) compare("band " + juce::String(band), bandDecibels[band], golden.bandDecibels[band], golden.rmsDecibels - Resolution);
+        compare("thd", thdDecibels, golden.thdDecibels, -Resolution);
+        return isMatch;
+    }
+
+    // golden fingerprints are stored as JSON
+    juce::var toVar() const {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("peak", peakDecibels);
+        object->setProperty("rms", rmsDecibels);
+        juce::Array<juce::var> bands;
+        for (float band : bandDecibels) bands.add(band);
+        object->setProperty("bands", bands);
+        object->setProperty("thd", thdDecibels);
+        return juce::var(object);
+    }
+    static AudioFingerprint fromVar(const juce::var& value) {
+        AudioFingerprint result;
+        result.peakDecibels = value.getProperty("peak", Floor);
+        result.rmsDecibels = value.getProperty("rms", Floor);
+        result.thdDecibels = value.getProperty("thd", Floor);
+        const auto bands = value.getProperty("bands", juce::var());
+        for (int band = 0; band < NumBands; band++) result.bandDecibels[band] = band < bands.size() ? (float)bands[band] : Floor;
+        return result;
+    }
+};
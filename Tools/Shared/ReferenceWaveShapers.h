@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    ReferenceWaveShapers.h
+    Created: 21 Oct 2026 6:40:19am
+    Author:  traxx
+
+    The waveshaper curves as std::function closures, as getWaveshaperFunction built them before the kernels of
+    WaveShaperKernels.h. Reference for the benchmark's timings and for the kernel check of the regression tests.
+    Test code only, shared by the tools; the plugin doesn't build it
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/DSP/Chain.h"
+
+// getWaveshaperFunction as it was before the kernels: a closure per curve, chosen by a switch, called per sample
+inline std::function<float(float)> getReferenceFunction(WaveShaperFunction func, float amount) {
+    switch (func) {
+        case HardClip:
+            return [amount](float x) { return juce::jlimit(0.f - (1.f - amount), 1.f - amount, x) + (x < 0 ? -amount : amount); };
+        case SoftClip:
+            return [amount](float x) { return juce::jlimit(-1.f, 1.f, x * std::sqrt(1 + ((amount * 5) * (amount * 5)))); };
+        case Cracked:
+            return [amount](float x) { return juce::jlimit(-1.f, 1.f, (float)(std::pow(x, 3) * std::pow((std::cos(x * amount * 9.4f)), 3))); };
+        case GNOME:
+            return [amount](float x) { return juce::jlimit(-1.f, 1.f, x == 0 ? 0 : x - (amount / x)); };
+        case Warm:
+            return [amount](float x) {
+                if (x <= 0) return juce::jlimit(-1.f, 1.f, x * (1.f - amount));
+                return juce::jlimit(-1.f, 1.f, x * (1.f + amount));
+            };
+        case Quantize: {
+            int numSteps = 1 + (int)std::floor((1 / (amount + 0.01f)) * 2);
+            return [numSteps](float x) {
+                int quant = (std::min(numSteps, (int)(std::abs(x * numSteps))));
+                return juce::jlimit(-1.f, 1.f, (float)(x < 0 ? (0 - ((1.f / numSteps) * quant)) : ((1.f / numSteps) * quant)));
+            };
+        }
+        case Fuzz:
+            return [amount](float x) { return juce::jlimit(-1.f, 1.f, x + (amount * std::sin(10 * amount * x))); };
+        case Hollowing:
+            return [amount](float x) { return juce::jlimit(-1.f, 1.f, x * (3 * amount * std::sin(x)) - x - amount); };
+        case Sin:
+            return [amount](float x) { return juce::jlimit(-1.f, 1.f, 2 * amount * std::sin(x * 100 * amount) + ((1 - amount) * x)); };
+        case Rash:
+            return [amount](float x) {
+                static constexpr float noise[] = { 2.22f, 3.21f, 1.38f, 0.21f, 3.66f, 1.51f, 3.41f, 2.14f, 2.09f, 0.31f, 1.15f, 3.15f, 2.58f, 0.91f, 1.18f, 4.29f, 3.24f, 0.11f, 0.05f, 2.11f, 1.77f };
+                const float factor =
+                    (x < -0.9f) ? noise[0] : (x < -0.8f) ? noise[1] :
+                    (x < -0.7f) ? noise[2] : (x < -0.6f) ? noise[3] :
+                    (x < -0.5f) ? noise[4] : (x < -0.4f) ? noise[5] :
+                    (x < -0.3f) ? noise[6] : (x < -0.2f) ? noise[7] :
+                    (x < -0.1f) ? noise[8] : (x < 0.f) ? noise[9] :
+                    (x < 0.1f) ? noise[10] : (x < 0.2f) ? noise[11] :
+                    (x < 0.3f) ? noise[12] : (x < 0.4f) ? noise[13] :
+                    (x < 0.5f) ? noise[14] : (x < 0.6f) ? noise[15] :
+                    (x < 0.7f) ? noise[16] : (x < 0.8f) ? noise[17] :
+                    (x < 0.9f) ? noise[18] : (x < 1.f) ? noise[19] : noise[20];
+                return juce::jlimit(-1.f, 1.f, (factor * x * amount) + (x * (1.f - amount)));
+            };
+        case Spiked: {
+            const float pi3p16 = 3 * 3.14159f / 16;
+            return [amount, pi3p16](float x) {
+                if (x < -pi3p16) return juce::jlimit(-1.f, 1.f, amount + (x * (1.f - amount)));
+                if (x < 0) return juce::jlimit(-1.f, 1.f, (std::sin(8 * x) * amount) + (x * (1.f - amount)));
+                if (x < 0.25f) return juce::jlimit(-1.f, 1.f, ((std::sin(10 * x) + 0.25f) * amount) + (x * (1.f - amount)));
+                if (x < 0.5f) return juce::jlimit(-1.f, 1.f, ((std::sin(10 * x + 1) + 0.25f) * amount) + (x * (1.f - amount)));
+                if (x < 0.75f) return juce::jlimit(-1.f, 1.f, ((std::sin(10 * x + 2) + 0.25f) * amount) + (x * (1.f - amount)));
+                return juce::jlimit(-1.f, 1.f, x * (1.f - amount) + amount);
+            };
+        }
+        case Titruff:
+            return [amount](float x) {
+                if (x > -0.162f && x < 0.162f) return ((-10.f * x * x + 1) * amount) + (x * (1.f - amount));
+                return juce::jlimit(-1.f, 1.f, ((-0.5f * x * x + 0.75f) * amount) + (x * (1.f - amount)));
+            };
+    }
+    return [](float x) { return x; };
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 21 Oct 2026 2:58:41am
+    Author:  traxx
+
+    Per-sample cost of every WaveShaperFunction: the per-curve block loops of WaveShaperKernels.h against the
+    std::function closures they replaced (ReferenceWaveShapers.h), same pre-gain, bias and gain around the curve.
+    Build in Release; the numbers in the commit introducing the kernels came from the defaults, compiled with -O3.
+
+    Usage: WaveShaperBenchmark [--blocksize=512] [--runs=20000] [--amount=0.4] [--fast]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/DSP/Chain.h"
+#include "../../../Source/DSP/WaveShaperKernels.h"
+#include "../../Shared/ReferenceWaveShapers.h"
+
+static constexpr float PreGain = 1.5f, Bias = 0.1f, Gain = 0.8f;
+
+// nanoseconds per sample of run(), over runs blocks
+template<typename Function>
+static double measure(Function&& run, int blockSize, int runs) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) run();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ((double)blockSize * runs);
+}
+
+int main(int argc, char* argv[]) {
+    const juce::ArgumentList args(argc, argv);
+    auto getOption = [&args](const juce::String& option, double defaultValue) {
+        return args.containsOption(option) ? args.getValueForOption(option).getDoubleValue() : defaultValue;
+    };
+    const int blockSize = juce::jmax(1, (int)getOption("--blocksize", 512));
+    const int runs = juce::jmax(1, (int)getOption("--runs", 20000));
+    const float amount = (float)getOption("--amount", 0.4);
+    const bool useFastMath = args.containsOption("--fast");
+
+    // a sine within the curves' input range; the same input for both versions
+    std::vector<float> input((size_t)blockSize), output((size_t)blockSize);
+    for (int i = 0; i < blockSize; i++) input[i] = 0.9f * std::sin(0.05f * i);
+    volatile float sink = 0.f;      // keeps the results alive
+
+    std::cout << "block size " << blockSize << ", " << runs << " runs, amount " << amount << (useFastMath ? ", fast math" : "") << "\n";
+    std::cout << "function     closure ns  kernel ns  speedup\n";
+    for (int function = 0; function < WaveShaperOptions.size(); function++) {
+        const auto closure = getReferenceFunction(static_cast<WaveShaperFunction>(function), amount);
+        const double closureCost = measure([&] {
+            for (int i = 0; i < blockSize; i++) output[i] = closure((input[i] * PreGain) + Bias) * Gain;
+            sink = sink + output[0];
+        }, blockSize, runs);
+
+        const auto shapeBlock = Kernels::getShapeBlock<false>(function, useFastMath);
+        const double kernelCost = measure([&] {
+            shapeBlock(input.data(), output.data(), blockSize, { amount }, { PreGain }, Bias, Gain, nullptr);
+            sink = sink + output[0];
+        }, blockSize, runs);
+
+        std::cout << WaveShaperOptions[function].paddedRight(' ', 12) << " "
+                  << juce::String(closureCost, 2).paddedLeft(' ', 10) << " " << juce::String(kernelCost, 2).paddedLeft(' ', 10) << "  x"
+                  << juce::String(closureCost / kernelCost, 1) << "\n";
+    }
+    return 0;
+}